@@ -1,76 +1,122 @@
-#-------------------------------------------------
-#
-# Project created by QtCreator 2019-09-02T11:05:58
-#
-#-------------------------------------------------
-
-QT       += core gui xml
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-TARGET = resources_scheduler
-TEMPLATE = app
-
-# The following define makes your compiler emit warnings if you use
-# any feature of Qt which has been marked as deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
-
-# You can also make your code fail to compile if you use deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-CONFIG += c++11
-
-SOURCES += \
-    src/main.cpp \
-    src/models/tablemodel.cpp \
-    src/utils/frameless_helper.cpp \
-    src/views/mainwindow.cpp \
-    src/views/titlebar.cpp \
-    src/views/widget.cpp
-
-HEADERS += \
-    src/models/elements.h \
-    src/models/tablemodel.h \
-    src/utils/frameless_helper.h \
-    src/utils/macro.h \
-    src/views/mainwindow.h \
-    src/views/titlebar.h \
-    src/views/widget.h
-
-INCLUDEPATH += qgis
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    qdarkstyle/style.qrc
-
-# 第三方库加载
-QGIS_3RD_PARTY = $$PWD/3rdparty
-QGIS_LIB_PATH = $${QGIS_3RD_PARTY}/qgis3.4.9/lib
-
-INCLUDEPATH += $${QGIS_3RD_PARTY}
-INCLUDEPATH += $${QGIS_3RD_PARTY}/qgis3.4.9/include
-
-CONFIG(debug,debug|release){
-    LIBS += $${QGIS_LIB_PATH}/Debug/gdal_i.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_analysis.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_app.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_core.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_customwidgets.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_gui.lib
-    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_native.lib
-}else{
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_analysis.lib
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_app.lib
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_core.lib
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_customwidgets.lib
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_gui.lib
-    LIBS += $${QGIS_LIB_PATH}/Release/qgis_native.lib
-}
+#-------------------------------------------------
+#
+# Project created by QtCreator 2019-09-02T11:05:58
+#
+#-------------------------------------------------
+
+QT       += core gui xml network
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = resources_scheduler
+TEMPLATE = app
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which has been marked as deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if you use deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+CONFIG += c++11
+
+SOURCES += \
+    src/io/replay_engine.cpp \
+    src/io/session_reader.cpp \
+    src/io/session_recorder.cpp \
+    src/io/telemetry_codec.cpp \
+    src/io/telemetry_receiver.cpp \
+    src/io/tile_archive.cpp \
+    src/io/tile_directory.cpp \
+    src/main.cpp \
+    src/map/raw_tile_cache.cpp \
+    src/map/tile_cache.cpp \
+    src/map/tile_loader.cpp \
+    src/map/tile_prefetcher.cpp \
+    src/map/xyz_tile_provider.cpp \
+    src/models/column_store.cpp \
+    src/models/element_descriptor.cpp \
+    src/models/element_record.cpp \
+    src/models/element_registry.cpp \
+    src/models/keyed_tablemodel.cpp \
+    src/models/live_proxy_model.cpp \
+    src/models/record_conflator.cpp \
+    src/models/tablemodel.cpp \
+    src/utils/frameless_helper.cpp \
+    src/views/mainwindow.cpp \
+    src/views/refresh_scheduler.cpp \
+    src/views/titlebar.cpp \
+    src/views/widget.cpp
+
+HEADERS += \
+    src/io/replay_engine.h \
+    src/io/session_format.h \
+    src/io/session_reader.h \
+    src/io/session_recorder.h \
+    src/io/telemetry_codec.h \
+    src/io/telemetry_receiver.h \
+    src/io/tile_archive.h \
+    src/io/tile_archive_format.h \
+    src/io/tile_directory.h \
+    src/io/tile_source.h \
+    src/map/raw_tile_cache.h \
+    src/map/tile_cache.h \
+    src/map/tile_loader.h \
+    src/map/tile_prefetcher.h \
+    src/map/xyz_tile_provider.h \
+    src/models/column_store.h \
+    src/models/element_descriptor.h \
+    src/models/element_record.h \
+    src/models/element_registry.h \
+    src/models/elements.h \
+    src/models/keyed_tablemodel.h \
+    src/models/live_proxy_model.h \
+    src/models/record_conflator.h \
+    src/models/tablemodel.h \
+    src/utils/command_line.h \
+    src/utils/frameless_helper.h \
+    src/utils/function_runnable.h \
+    src/utils/macro.h \
+    src/utils/spsc_ring.h \
+    src/views/mainwindow.h \
+    src/views/refresh_scheduler.h \
+    src/views/titlebar.h \
+    src/views/widget.h
+
+INCLUDEPATH += qgis
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    qdarkstyle/style.qrc
+
+# 第三方库加载
+QGIS_3RD_PARTY = $$PWD/3rdparty
+QGIS_LIB_PATH = $${QGIS_3RD_PARTY}/qgis3.4.9/lib
+
+INCLUDEPATH += $${QGIS_3RD_PARTY}
+INCLUDEPATH += $${QGIS_3RD_PARTY}/qgis3.4.9/include
+
+CONFIG(debug,debug|release){
+    LIBS += $${QGIS_LIB_PATH}/Debug/gdal_i.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_analysis.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_app.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_core.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_customwidgets.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_gui.lib
+    LIBS += $${QGIS_LIB_PATH}/Debug/qgis_native.lib
+}else{
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_analysis.lib
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_app.lib
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_core.lib
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_customwidgets.lib
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_gui.lib
+    LIBS += $${QGIS_LIB_PATH}/Release/qgis_native.lib
+}
@@ -0,0 +1,189 @@
+#include "replay_engine.h"
+
+#include <algorithm>
+
+//最快速度时每次定时最多占用的时间
+static const qint64 MAX_SPEED_BUDGET_NS = 8 * 1000 * 1000;
+
+ReplayEngine::ReplayEngine(QObject *parent) : QObject(parent) {
+    timer_.setTimerType(Qt::PreciseTimer);
+    connect(&timer_, &QTimer::timeout, this, &ReplayEngine::on_timer);
+}
+
+bool ReplayEngine::open(const QString &path, QString *perror) {
+    close();
+    if (!reader_.open(path, perror)) return false;
+
+    seek(reader_.first_timestamp());
+    return true;
+}
+
+void ReplayEngine::close() {
+    timer_.stop();
+    reader_.close();
+    pchunk_ = nullptr;
+    chunk_size_ = 0;
+    chunk_ = -1;
+    next_record_ = 0;
+    resync_keyframe_ = -1;
+    resync_chunk_ = -1;
+    position_ = 0;
+}
+
+void ReplayEngine::set_speed(double speed) {
+    speed_ = qMax(0.0, speed);
+    restart_clock();
+}
+
+void ReplayEngine::seek(qint64 timestamp) {
+    if (!reader_.is_open()) return;
+    timestamp = qBound(reader_.first_timestamp(), timestamp, reader_.last_timestamp());
+    batch_.resize(0);
+
+    // 1.向后跳转不超过一个关键帧间隔时直接补发中间的记录
+    bool forward = chunk_ >= 0 && timestamp >= position_ && timestamp - position_ <= SESSION_KEYFRAME_INTERVAL;
+    if (!forward) {
+        // 2.否则从目标之前最近的可读关键帧恢复, 没有关键帧时从头开始
+        int keyframe = reader_.find_keyframe(timestamp - 1);
+        int chunk = 0;
+        for (; keyframe >= 0; keyframe--) {
+            int count = 0;
+            const ElementRecord *precords = reader_.keyframe_records(keyframe, &count);
+            if (precords == nullptr) {
+                emit sig_error(tr("会话记录中的关键帧已损坏, 改用更早的关键帧"));
+                continue;
+            }
+            batch_.resize(count);
+            std::copy(precords, precords + count, batch_.begin());
+            chunk = reader_.keyframe_chunk(keyframe);
+            break;
+        }
+
+        //增量记录从 chunk 开始, 由 collect() 载入
+        pchunk_ = nullptr;
+        chunk_size_ = 0;
+        chunk_ = chunk - 1;
+        next_record_ = 0;
+        resync_chunk_ = -1;
+        emit sig_reset();
+    }
+
+    // 3.补发目标时刻之前的增量记录, 不按时间预算
+    collect(timestamp - 1, 0);
+    if (!batch_.isEmpty()) emit sig_records(batch_);
+
+    position_ = timestamp;
+    restart_clock();
+    emit sig_position(position_);
+}
+
+void ReplayEngine::play() {
+    if (!reader_.is_open() || timer_.isActive()) return;
+    restart_clock();
+    timer_.start(10);
+}
+
+void ReplayEngine::pause() { timer_.stop(); }
+
+void ReplayEngine::restart_clock() {
+    clock_base_ = position_;
+    clock_.start();
+}
+
+bool ReplayEngine::load_chunk(int chunk) {
+    if (chunk == chunk_) return true;
+    int count = 0;
+    const ElementRecord *precords = reader_.chunk_records(chunk, &count);
+    if (precords == nullptr) return false;
+    pchunk_ = precords;
+    chunk_size_ = count;
+    chunk_ = chunk;
+    next_record_ = 0;
+    return true;
+}
+
+bool ReplayEngine::next_chunk() {
+    //载入下一块, 无法读取的块跳过, 没有下一块时返回 false
+    while (chunk_ + 1 < reader_.chunk_count()) {
+        int chunk = chunk_ + 1;
+        if (chunk == resync_chunk_) apply_resync();
+        if (load_chunk(chunk)) return true;
+
+        emit sig_error(tr("会话记录第 %1 块已损坏, 已跳过").arg(chunk + 1));
+        pchunk_ = nullptr;
+        chunk_size_ = 0;
+        chunk_ = chunk;
+        next_record_ = 0;
+        if (resync_chunk_ < 0) schedule_resync(chunk);
+    }
+    return false;
+}
+
+void ReplayEngine::schedule_resync(int bad_chunk) {
+    //损坏块之后的第一个关键帧包含该块丢失的变化
+    resync_keyframe_ = -1;
+    resync_chunk_ = -1;
+    for (int keyframe = 0; keyframe < reader_.keyframe_count(); keyframe++) {
+        int chunk = reader_.keyframe_chunk(keyframe);
+        if (chunk <= bad_chunk) continue;
+        resync_keyframe_ = keyframe;
+        resync_chunk_ = chunk;
+        return;
+    }
+}
+
+void ReplayEngine::apply_resync() {
+    //关键帧覆盖到上一块为止, 已收集的增量记录被它取代
+    int chunk = resync_chunk_;
+    int count = 0;
+    const ElementRecord *precords = reader_.keyframe_records(resync_keyframe_, &count);
+    if (precords == nullptr) {
+        emit sig_error(tr("会话记录中的关键帧已损坏, 等待下一个关键帧"));
+        schedule_resync(chunk);
+        return;
+    }
+
+    resync_keyframe_ = -1;
+    resync_chunk_ = -1;
+    batch_.resize(count);
+    std::copy(precords, precords + count, batch_.begin());
+    emit sig_reset();
+}
+
+bool ReplayEngine::collect(qint64 target, qint64 budget_ns) {
+    //把时间戳不大于 target 的记录追加到 batch_, 超出时间预算时在块边界停止, 到文件末尾返回 false
+    QElapsedTimer budget;
+    budget.start();
+
+    for (;;) {
+        if (next_record_ >= chunk_size_) {
+            if (!next_chunk()) return false;
+            if (budget_ns > 0 && budget.nsecsElapsed() > budget_ns) return true;
+        }
+
+        const ElementRecord &record = pchunk_[next_record_];
+        if (record.timestamp > target) return true;
+        batch_.append(record);
+        position_ = record.timestamp;
+        next_record_++;
+    }
+}
+
+void ReplayEngine::on_timer() {
+    //按速度换算本次应回放到的位置, 最快速度时按时间预算处理
+    bool max_speed = (speed_ <= 0.0);
+    qint64 target = max_speed ? reader_.last_timestamp()
+                              : clock_base_ + static_cast<qint64>(clock_.elapsed() * speed_);
+
+    batch_.resize(0);
+    bool finished = !collect(target, max_speed ? MAX_SPEED_BUDGET_NS : 0);
+    if (!max_speed && !finished) position_ = qMax(position_, target);
+
+    if (!batch_.isEmpty()) emit sig_records(batch_);
+    emit sig_position(position_);
+
+    if (finished) {
+        timer_.stop();
+        emit sig_finished();
+    }
+}
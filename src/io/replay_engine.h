@@ -0,0 +1,80 @@
+#ifndef __REPLAY_ENGINE_H__
+#define __REPLAY_ENGINE_H__
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include "session_reader.h"
+
+/*
+ *  按记录时间回放会话文件, 在界面线程中由定时器驱动
+ *  每次定时按 速度 x 经过时间 推进回放位置, 把到期的记录通过 sig_records 交给界面,
+ *  与实时数据走同一条合并和刷新路径; 最快速度时每次定时只处理固定时长, 不阻塞界面
+ *  跳转时先发 sig_reset, 再发最近关键帧和其后到目标时刻的增量记录, 不从文件开头重放
+ *  损坏的块跳过并通过 sig_error 报告, 回放到其后第一个关键帧时再发 sig_reset 和关键帧, 恢复完整状态
+ */
+class ReplayEngine : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ReplayEngine(QObject *parent = nullptr);
+
+    bool open(const QString &path, QString *perror = nullptr);
+    void close();
+    bool is_open() const { return reader_.is_open(); }
+    bool is_playing() const { return timer_.isActive(); }
+
+    //记录时间戳(毫秒)与开始记录时刻的对应关系见 session_format.h
+    qint64 start_time() const { return reader_.start_time(); }
+    qint64 first_timestamp() const { return reader_.first_timestamp(); }
+    qint64 last_timestamp() const { return reader_.last_timestamp(); }
+    qint64 position() const { return position_; }
+
+    //回放速度倍数, 0 表示不按时间尽快回放
+    void set_speed(double speed);
+    double speed() const { return speed_; }
+    //跳转后界面状态为 timestamp 之前的全部记录, 下一条回放记录的时间不小于 timestamp
+    void seek(qint64 timestamp);
+
+signals:
+    void sig_reset(); //之后发出的记录为完整状态, 界面需先清空
+    void sig_records(const QVector<ElementRecord> &records);
+    void sig_position(qint64 timestamp);
+    void sig_finished();
+    void sig_error(const QString &message);
+
+public slots:
+    void play();
+    void pause();
+
+private slots:
+    void on_timer();
+
+private:
+    bool load_chunk(int chunk);
+    bool next_chunk();
+    void schedule_resync(int bad_chunk);
+    void apply_resync();
+    bool collect(qint64 target, qint64 budget_ns);
+    void restart_clock();
+
+private:
+    SessionReader reader_;
+    QTimer timer_;
+    QElapsedTimer clock_;
+    qint64 clock_base_ = 0; //clock_ 开始计时时的回放位置
+    double speed_ = 1.0;
+    qint64 position_ = 0;
+
+    const ElementRecord *pchunk_ = nullptr; //当前块, 指向读取器的映射区
+    int chunk_size_ = 0;
+    int chunk_ = -1;
+    int next_record_ = 0;                  //当前块中下一条待回放记录
+    int resync_keyframe_ = -1;             //跳过损坏块后用来恢复状态的关键帧
+    int resync_chunk_ = -1;                //回放到这一块之前应用 resync_keyframe_
+    QVector<ElementRecord> batch_;
+};
+
+#endif //__REPLAY_ENGINE_H__
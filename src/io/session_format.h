@@ -0,0 +1,91 @@
+#ifndef __SESSION_FORMAT_H__
+#define __SESSION_FORMAT_H__
+
+#include <QtGlobal>
+
+#include "src/models/element_record.h"
+
+/*
+ *  会话记录文件格式(主机字节序, 小端):
+ *
+ *      文件头 SessionFileHeader
+ *      块序列, 每块以 SessionBlockHeader 开头, size 为块头之后的字节数
+ *          RECS  SessionChunkHeader + count 条 ElementRecord(每条 128 字节, 时间戳递增)
+ *          KEYF  SessionKeyframeHeader + count 条 ElementRecord, 截至 timestamp 每个 (类型, 主键) 的最新值,
+ *                紧跟在它所覆盖的最后一个 RECS 块之后
+ *          INDX  SessionIndexHeader + count 个 RECS 块的 SessionIndexEntry + keyframes 个 KEYF 块的
+ *                SessionIndexEntry, 指向上一个索引块之后写入的块
+ *          TAIL  SessionTrailer, 正常关闭时写在文件末尾
+ *
+ *  文件只追加不修改; 没有 TAIL 时(如程序异常退出)可从文件头顺序扫描各块恢复
+ */
+#define SESSION_TAG(a, b, c, d) (quint32(a) | (quint32(b) << 8) | (quint32(c) << 16) | (quint32(d) << 24))
+
+const quint32 SESSION_MAGIC = SESSION_TAG('E', 'D', 'C', 'S');
+const quint16 SESSION_VERSION = 1;
+const quint32 SESSION_TAG_RECORDS = SESSION_TAG('R', 'E', 'C', 'S');
+const quint32 SESSION_TAG_KEYFRAME = SESSION_TAG('K', 'E', 'Y', 'F');
+const quint32 SESSION_TAG_INDEX = SESSION_TAG('I', 'N', 'D', 'X');
+const quint32 SESSION_TAG_TRAILER = SESSION_TAG('T', 'A', 'I', 'L');
+
+const int SESSION_CHUNK_RECORDS = 1024;   //单个 RECS 块最多记录数
+const int SESSION_INDEX_INTERVAL = 32;    //每隔多少个 RECS 块写一个索引块
+const qint64 SESSION_KEYFRAME_INTERVAL = 10 * 1000; //关键帧间隔, 记录时间毫秒
+const int SESSION_PENDING_LIMIT = 64 * SESSION_CHUNK_RECORDS; //待写缓冲区上限, 约 8MB
+
+struct SessionFileHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 record_size; // sizeof(ElementRecord)
+    qint64 start_time;   //开始记录的时间, 自 1970 年起的毫秒数, 近似对应记录时间戳 0(接收线程同时启动)
+    qint64 reserved[2];
+};
+
+struct SessionBlockHeader {
+    quint32 tag;
+    quint32 size;
+};
+
+struct SessionChunkHeader {
+    quint32 count;
+    quint32 reserved;
+    qint64 first_timestamp;
+    qint64 last_timestamp;
+};
+
+struct SessionKeyframeHeader {
+    qint64 timestamp; //关键帧覆盖到的最后记录时间
+    quint32 count;
+    quint32 reserved;
+};
+
+struct SessionIndexHeader {
+    qint64 prev_index; //上一个索引块的文件偏移, 没有时为 -1
+    quint32 count;     // RECS 块条目数
+    quint32 keyframes; // KEYF 块条目数, 跟在 RECS 条目之后
+};
+
+struct SessionIndexEntry {
+    qint64 first_timestamp; // KEYF 块为关键帧时间
+    qint64 offset;          //块头的文件偏移
+};
+
+struct SessionTrailer {
+    qint64 last_index; //最后一个索引块的文件偏移
+    quint64 record_count;
+    qint64 first_timestamp;
+    qint64 last_timestamp;
+    quint32 magic;
+    quint32 reserved;
+};
+
+static_assert(sizeof(SessionFileHeader) == 32, "SessionFileHeader layout");
+static_assert(sizeof(SessionBlockHeader) == 8, "SessionBlockHeader layout");
+static_assert(sizeof(SessionChunkHeader) == 24, "SessionChunkHeader layout");
+static_assert(sizeof(SessionKeyframeHeader) == 16, "SessionKeyframeHeader layout");
+static_assert(sizeof(SessionIndexHeader) == 16, "SessionIndexHeader layout");
+static_assert(sizeof(SessionIndexEntry) == 16, "SessionIndexEntry layout");
+static_assert(sizeof(SessionTrailer) == 40, "SessionTrailer layout");
+static_assert(sizeof(ElementRecord) == 128, "ElementRecord layout");
+
+#endif //__SESSION_FORMAT_H__
@@ -0,0 +1,225 @@
+#include "session_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+//整个文件映射到一段连续地址, 32 位进程的地址空间碎片化后放不下更大的文件
+static const qint64 MAX_MAP_SIZE_32 = 1024 * 1024 * 1024;
+
+bool SessionReader::open(const QString &path, QString *perror) {
+    close();
+
+    file_.setFileName(path);
+    if (!file_.open(QFile::ReadOnly)) {
+        if (perror != nullptr) *perror = file_.errorString();
+        return false;
+    }
+    map_size_ = file_.size();
+    if (map_size_ < static_cast<qint64>(sizeof(header_))) {
+        if (perror != nullptr) *perror = QObject::tr("不是会话记录文件");
+        close();
+        return false;
+    }
+    if (sizeof(void *) < 8 && map_size_ > MAX_MAP_SIZE_32) {
+        if (perror != nullptr)
+            *perror = QObject::tr("会话记录文件过大(%1MB), 32 位程序最多打开 %2MB")
+                          .arg(map_size_ >> 20)
+                          .arg(MAX_MAP_SIZE_32 >> 20);
+        close();
+        return false;
+    }
+    pmap_ = file_.map(0, map_size_);
+    if (pmap_ == nullptr) {
+        if (perror != nullptr)
+            *perror = QObject::tr("无法映射会话记录文件(%1MB): %2").arg(map_size_ >> 20).arg(file_.errorString());
+        close();
+        return false;
+    }
+
+    QString error;
+    if (!read_at(0, &header_, sizeof(header_)) || header_.magic != SESSION_MAGIC) {
+        error = QObject::tr("不是会话记录文件");
+    } else if (header_.version != SESSION_VERSION || header_.record_size != sizeof(ElementRecord)) {
+        error = QObject::tr("不支持的会话记录版本 %1").arg(header_.version);
+    } else {
+        // 1.有完整文件尾时沿索引块链加载, 否则顺序扫描
+        SessionBlockHeader block;
+        SessionTrailer trailer;
+        qint64 tail = map_size_ - static_cast<qint64>(sizeof(block) + sizeof(trailer));
+        bool has_trailer = tail >= static_cast<qint64>(sizeof(header_)) && read_at(tail, &block, sizeof(block)) &&
+                           block.tag == SESSION_TAG_TRAILER && read_at(tail + sizeof(block), &trailer, sizeof(trailer)) &&
+                           trailer.magic == SESSION_MAGIC;
+
+        recovered_ = !has_trailer || !load_index(trailer);
+        if (recovered_ && !scan_blocks()) error = QObject::tr("会话记录文件已损坏");
+    }
+
+    if (error.isEmpty() && chunks_.isEmpty()) error = QObject::tr("会话记录为空");
+    if (!error.isEmpty()) {
+        if (perror != nullptr) *perror = error;
+        close();
+        return false;
+    }
+
+    // 2.最后一块的结束时间从块头读取
+    SessionChunkHeader head;
+    if (read_at(chunks_.last().offset + sizeof(SessionBlockHeader), &head, sizeof(head)))
+        last_timestamp_ = head.last_timestamp;
+    first_timestamp_ = chunks_.first().first_timestamp;
+    return true;
+}
+
+void SessionReader::close() {
+    if (pmap_ != nullptr) file_.unmap(pmap_);
+    pmap_ = nullptr;
+    map_size_ = 0;
+    file_.close();
+    chunks_.clear();
+    keyframes_.clear();
+    std::memset(&header_, 0, sizeof(header_));
+    first_timestamp_ = 0;
+    last_timestamp_ = 0;
+    recovered_ = false;
+}
+
+bool SessionReader::load_index(const SessionTrailer &trailer) {
+    //索引块链从后往前, 每块内按时间升序
+    QVector<QVector<SessionIndexEntry>> blocks;
+    QVector<QVector<SessionIndexEntry>> keyframes;
+    qint64 offset = trailer.last_index;
+    while (offset >= 0) {
+        SessionBlockHeader block;
+        SessionIndexHeader head;
+        if (!read_at(offset, &block, sizeof(block)) || block.tag != SESSION_TAG_INDEX ||
+            !read_at(offset + sizeof(block), &head, sizeof(head)) ||
+            block.size != sizeof(head) + (head.count + head.keyframes) * sizeof(SessionIndexEntry) ||
+            head.prev_index >= offset)
+            return false;
+
+        QVector<SessionIndexEntry> entries(head.count + head.keyframes);
+        if (!read_at(offset + sizeof(block) + sizeof(head), entries.data(), entries.size() * sizeof(SessionIndexEntry)))
+            return false;
+        blocks.append(entries.mid(0, head.count));
+        keyframes.append(entries.mid(head.count));
+        offset = head.prev_index;
+    }
+
+    chunks_.clear();
+    keyframes_.clear();
+    for (int i = blocks.size() - 1; i >= 0; i--) {
+        chunks_ += blocks.at(i);
+        keyframes_ += keyframes.at(i);
+    }
+    return true;
+}
+
+bool SessionReader::scan_blocks() {
+    //按块头顺序跳读, 末尾不完整的块忽略
+    chunks_.clear();
+    keyframes_.clear();
+    qint64 offset = sizeof(header_);
+    qint64 size = map_size_;
+    while (offset + static_cast<qint64>(sizeof(SessionBlockHeader)) <= size) {
+        SessionBlockHeader block;
+        if (!read_at(offset, &block, sizeof(block))) break;
+        qint64 next = offset + sizeof(block) + block.size;
+        if (next > size) break;
+
+        if (block.tag == SESSION_TAG_RECORDS) {
+            SessionChunkHeader head;
+            if (!read_at(offset + sizeof(block), &head, sizeof(head)) ||
+                block.size != sizeof(head) + head.count * sizeof(ElementRecord))
+                return false;
+
+            SessionIndexEntry entry;
+            entry.first_timestamp = head.first_timestamp;
+            entry.offset = offset;
+            chunks_.append(entry);
+        } else if (block.tag == SESSION_TAG_KEYFRAME) {
+            SessionKeyframeHeader head;
+            if (!read_at(offset + sizeof(block), &head, sizeof(head)) ||
+                block.size != sizeof(head) + head.count * sizeof(ElementRecord))
+                return false;
+
+            SessionIndexEntry entry;
+            entry.first_timestamp = head.timestamp;
+            entry.offset = offset;
+            keyframes_.append(entry);
+        } else if (block.tag != SESSION_TAG_INDEX && block.tag != SESSION_TAG_TRAILER) {
+            return false;
+        }
+        offset = next;
+    }
+    return true;
+}
+
+int SessionReader::find_chunk(qint64 timestamp) const {
+    auto it = std::upper_bound(chunks_.constBegin(), chunks_.constEnd(), timestamp,
+                               [](qint64 t, const SessionIndexEntry &e) { return t < e.first_timestamp; });
+    int chunk = static_cast<int>(it - chunks_.constBegin()) - 1;
+    return qMax(chunk, 0);
+}
+
+const ElementRecord *SessionReader::chunk_records(int chunk, int *pcount) const {
+    if (chunk < 0 || chunk >= chunks_.size()) return nullptr;
+
+    qint64 offset = chunks_.at(chunk).offset;
+    SessionBlockHeader block;
+    SessionChunkHeader head;
+    if (!read_at(offset, &block, sizeof(block)) || block.tag != SESSION_TAG_RECORDS ||
+        !read_at(offset + sizeof(block), &head, sizeof(head)) ||
+        block.size != sizeof(head) + head.count * sizeof(ElementRecord))
+        return nullptr;
+
+    *pcount = head.count;
+    return map_records(offset + sizeof(block) + sizeof(head), head.count);
+}
+
+int SessionReader::find_keyframe(qint64 timestamp) const {
+    auto it = std::upper_bound(keyframes_.constBegin(), keyframes_.constEnd(), timestamp,
+                               [](qint64 t, const SessionIndexEntry &e) { return t < e.first_timestamp; });
+    return static_cast<int>(it - keyframes_.constBegin()) - 1;
+}
+
+int SessionReader::keyframe_chunk(int keyframe) const {
+    //块和关键帧都按文件偏移递增写入
+    qint64 offset = keyframes_.at(keyframe).offset;
+    auto it = std::upper_bound(chunks_.constBegin(), chunks_.constEnd(), offset,
+                               [](qint64 o, const SessionIndexEntry &e) { return o < e.offset; });
+    return static_cast<int>(it - chunks_.constBegin());
+}
+
+const ElementRecord *SessionReader::keyframe_records(int keyframe, int *pcount) const {
+    if (keyframe < 0 || keyframe >= keyframes_.size()) return nullptr;
+
+    qint64 offset = keyframes_.at(keyframe).offset;
+    SessionBlockHeader block;
+    SessionKeyframeHeader head;
+    if (!read_at(offset, &block, sizeof(block)) || block.tag != SESSION_TAG_KEYFRAME ||
+        !read_at(offset + sizeof(block), &head, sizeof(head)) ||
+        block.size != sizeof(head) + head.count * sizeof(ElementRecord))
+        return nullptr;
+
+    *pcount = head.count;
+    return map_records(offset + sizeof(block) + sizeof(head), head.count);
+}
+
+const uchar *SessionReader::map_at(qint64 offset, qint64 size) const {
+    if (pmap_ == nullptr || offset < 0 || size < 0 || offset > map_size_ - size) return nullptr;
+    return pmap_ + offset;
+}
+
+bool SessionReader::read_at(qint64 offset, void *pdata, qint64 size) const {
+    //块头等小结构复制出来, 不要求对齐
+    const uchar *p = map_at(offset, size);
+    if (p == nullptr) return false;
+    std::memcpy(pdata, p, size);
+    return true;
+}
+
+const ElementRecord *SessionReader::map_records(qint64 offset, quint32 count) const {
+    //各块长度都是 8 字节的整数倍, 记录在映射区中自然对齐, 可直接访问
+    const uchar *p = map_at(offset, static_cast<qint64>(count) * sizeof(ElementRecord));
+    if (p == nullptr || reinterpret_cast<quintptr>(p) % alignof(ElementRecord) != 0) return nullptr;
+    return reinterpret_cast<const ElementRecord *>(p);
+}
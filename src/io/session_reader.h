@@ -0,0 +1,61 @@
+#ifndef __SESSION_READER_H__
+#define __SESSION_READER_H__
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "session_format.h"
+
+/*
+ *  读取会话记录文件
+ *  打开时只加载块索引(有文件尾时沿索引块链读取, 否则顺序扫描块头)
+ *  整个文件只读映射到内存, 记录直接指向映射区, 不复制也不预读, 由系统按页调入
+ *  32 位程序的地址空间不足以映射大文件, 超过 1GB 的文件打开时直接报错
+ */
+class SessionReader {
+public:
+    bool open(const QString &path, QString *perror = nullptr);
+    void close();
+    bool is_open() const { return file_.isOpen(); }
+
+    qint64 start_time() const { return header_.start_time; }
+    qint64 first_timestamp() const { return first_timestamp_; }
+    qint64 last_timestamp() const { return last_timestamp_; }
+    int chunk_count() const { return chunks_.size(); }
+    bool recovered() const { return recovered_; } //没有文件尾, 由顺序扫描得到索引
+
+    //包含 timestamp 的块: 首时间戳不大于 timestamp 的最后一块, O(log n)
+    int find_chunk(qint64 timestamp) const;
+    //块内全部记录, 指针在 close() 之前有效; 块损坏时返回空指针
+    const ElementRecord *chunk_records(int chunk, int *pcount) const;
+
+    //关键帧: 时间不大于 timestamp 的最后一个, 没有时为 -1
+    int keyframe_count() const { return keyframes_.size(); }
+    int find_keyframe(qint64 timestamp) const;
+    qint64 keyframe_time(int keyframe) const { return keyframes_.at(keyframe).first_timestamp; }
+    //关键帧之后的第一块, 增量记录从这里开始
+    int keyframe_chunk(int keyframe) const;
+    const ElementRecord *keyframe_records(int keyframe, int *pcount) const;
+
+private:
+    bool load_index(const SessionTrailer &trailer);
+    bool scan_blocks();
+    const uchar *map_at(qint64 offset, qint64 size) const;
+    bool read_at(qint64 offset, void *pdata, qint64 size) const;
+    const ElementRecord *map_records(qint64 offset, quint32 count) const;
+
+private:
+    QFile file_;
+    uchar *pmap_ = nullptr;
+    qint64 map_size_ = 0;
+    SessionFileHeader header_;
+    QVector<SessionIndexEntry> chunks_;    //按时间戳升序
+    QVector<SessionIndexEntry> keyframes_; //按时间戳升序
+    qint64 first_timestamp_ = 0;
+    qint64 last_timestamp_ = 0;
+    bool recovered_ = false;
+};
+
+#endif //__SESSION_READER_H__
@@ -0,0 +1,211 @@
+#include "session_recorder.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <cstring>
+
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QObject(parent),
+      flush_requested_(false),
+      recorded_records_(0),
+      bytes_written_(0),
+      pending_high_water_(0),
+      dropped_records_(0) {}
+
+SessionRecorder::~SessionRecorder() { close(); }
+
+bool SessionRecorder::open(const QString &path, QString *perror) {
+    file_.setFileName(path);
+    if (!file_.open(QFile::WriteOnly | QFile::Truncate)) {
+        if (perror != nullptr) *perror = file_.errorString();
+        return false;
+    }
+
+    SessionFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SESSION_MAGIC;
+    header.version = SESSION_VERSION;
+    header.record_size = sizeof(ElementRecord);
+    header.start_time = QDateTime::currentMSecsSinceEpoch();
+    if (file_.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        if (perror != nullptr) *perror = file_.errorString();
+        file_.close();
+        return false;
+    }
+
+    bytes_written_ = sizeof(header);
+    return true;
+}
+
+void SessionRecorder::start() {
+    //定时把零散的小批次合并成块写盘
+    ptimer_ = new QTimer(this);
+    connect(ptimer_, &QTimer::timeout, this, &SessionRecorder::flush);
+    ptimer_->start(100);
+}
+
+void SessionRecorder::append(const ElementRecord *records, int count) {
+    if (count <= 0) return;
+
+    int size = 0;
+    int accepted = 0;
+    {
+        QMutexLocker locker(&mutex_);
+        int old = pending_.size();
+        accepted = qMin(count, SESSION_PENDING_LIMIT - old);
+        if (accepted > 0) {
+            pending_.resize(old + accepted);
+            std::memcpy(pending_.data() + old, records, accepted * sizeof(ElementRecord));
+        }
+        size = pending_.size();
+    }
+    if (accepted < count) dropped_records_ += count - accepted;
+
+    int seen = pending_high_water_.load();
+    while (size > seen && !pending_high_water_.compare_exchange_weak(seen, size)) {
+    }
+
+    //积累满一块时提前写盘, 不等定时器
+    if (size >= SESSION_CHUNK_RECORDS && !flush_requested_.exchange(true))
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+}
+
+void SessionRecorder::flush() {
+    flush_requested_.store(false);
+    if (!file_.isOpen()) return;
+
+    //交换缓冲区后在锁外写盘, 两块缓冲区的容量都保留复用
+    {
+        QMutexLocker locker(&mutex_);
+        pending_.swap(writing_);
+    }
+    if (writing_.isEmpty()) return;
+
+    for (int i = 0; i < writing_.size(); i += SESSION_CHUNK_RECORDS) {
+        write_chunk(writing_.constData() + i, qMin(SESSION_CHUNK_RECORDS, writing_.size() - i));
+    }
+    writing_.resize(0);
+    file_.flush();
+}
+
+void SessionRecorder::close() {
+    if (!file_.isOpen()) return;
+    if (ptimer_ != nullptr) ptimer_->stop();
+
+    flush();
+    if (!index_entries_.isEmpty() || !keyframe_entries_.isEmpty()) write_index();
+
+    SessionTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    trailer.last_index = last_index_;
+    trailer.record_count = recorded_records_.load();
+    trailer.first_timestamp = first_timestamp_;
+    trailer.last_timestamp = last_timestamp_;
+    trailer.magic = SESSION_MAGIC;
+    write_block(SESSION_TAG_TRAILER, &trailer, sizeof(trailer), nullptr, 0);
+
+    file_.close();
+}
+
+void SessionRecorder::write_chunk(const ElementRecord *records, int count) {
+    SessionChunkHeader head;
+    head.count = count;
+    head.reserved = 0;
+    head.first_timestamp = records[0].timestamp;
+    head.last_timestamp = records[count - 1].timestamp;
+
+    qint64 offset = file_.pos();
+    if (!write_block(SESSION_TAG_RECORDS, &head, sizeof(head), records, count * sizeof(ElementRecord))) return;
+
+    SessionIndexEntry entry;
+    entry.first_timestamp = head.first_timestamp;
+    entry.offset = offset;
+    index_entries_.append(entry);
+
+    if (first_timestamp_ < 0) first_timestamp_ = head.first_timestamp;
+    last_timestamp_ = head.last_timestamp;
+    recorded_records_ += count;
+
+    //更新全量状态, 到间隔时在本块之后写关键帧
+    for (int i = 0; i < count; i++) {
+        const ElementRecord &record = records[i];
+        auto key = qMakePair(record.type, record.key);
+        auto var = map_latest_.find(key);
+        if (record.flags & RECORD_REMOVED) {
+            //已删除的主键不再进入关键帧, 末尾项移到空出的位置
+            if (var == map_latest_.end()) continue;
+            int pos = var.value();
+            map_latest_.erase(var);
+            if (pos != latest_.size() - 1) {
+                latest_[pos] = latest_.last();
+                map_latest_[qMakePair(latest_.at(pos).type, latest_.at(pos).key)] = pos;
+            }
+            latest_.removeLast();
+        } else if (var != map_latest_.end()) {
+            latest_[var.value()] = record;
+        } else {
+            map_latest_.insert(key, latest_.size());
+            latest_.append(record);
+        }
+    }
+    if (last_keyframe_ < 0 || head.last_timestamp - last_keyframe_ >= SESSION_KEYFRAME_INTERVAL)
+        write_keyframe(head.last_timestamp);
+
+    if (index_entries_.size() >= SESSION_INDEX_INTERVAL) write_index();
+}
+
+void SessionRecorder::write_keyframe(qint64 timestamp) {
+    SessionKeyframeHeader head;
+    head.timestamp = timestamp;
+    head.count = latest_.size();
+    head.reserved = 0;
+
+    qint64 offset = file_.pos();
+    if (!write_block(SESSION_TAG_KEYFRAME, &head, sizeof(head), latest_.constData(),
+                     latest_.size() * sizeof(ElementRecord)))
+        return;
+
+    SessionIndexEntry entry;
+    entry.first_timestamp = timestamp;
+    entry.offset = offset;
+    keyframe_entries_.append(entry);
+    last_keyframe_ = timestamp;
+}
+
+void SessionRecorder::write_index() {
+    SessionIndexHeader head;
+    head.prev_index = last_index_;
+    head.count = index_entries_.size();
+    head.keyframes = keyframe_entries_.size();
+
+    QVector<SessionIndexEntry> entries = index_entries_ + keyframe_entries_;
+    qint64 offset = file_.pos();
+    if (!write_block(SESSION_TAG_INDEX, &head, sizeof(head), entries.constData(),
+                     entries.size() * sizeof(SessionIndexEntry)))
+        return;
+
+    last_index_ = offset;
+    index_entries_.clear();
+    keyframe_entries_.clear();
+}
+
+bool SessionRecorder::write_block(quint32 tag, const void *head, int head_size, const void *body, int body_size) {
+    if (failed_) return false;
+
+    SessionBlockHeader block;
+    block.tag = tag;
+    block.size = head_size + body_size;
+
+    bool ok = file_.write(reinterpret_cast<const char *>(&block), sizeof(block)) == sizeof(block) &&
+              file_.write(static_cast<const char *>(head), head_size) == head_size &&
+              (body_size == 0 || file_.write(static_cast<const char *>(body), body_size) == body_size);
+    if (!ok) {
+        //磁盘写满等错误只报告一次, 之后的记录不再写入
+        failed_ = true;
+        emit sig_error(tr("会话记录写入失败: %1").arg(file_.errorString()));
+        return false;
+    }
+
+    bytes_written_ += sizeof(block) + head_size + body_size;
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef __SESSION_RECORDER_H__
+#define __SESSION_RECORDER_H__
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+
+#include "session_format.h"
+
+/*
+ *  把解码后的全部记录追加写入会话文件, 运行在独立的写盘线程中
+ *  append() 可在任意线程调用, 只把记录拷入待写缓冲区; 写盘线程定时或积累到一块时
+ *  交换缓冲区后成块写入, 不阻塞解码和界面; 磁盘慢时缓冲区增长到 SESSION_PENDING_LIMIT 条为止,
+ *  超出的记录丢弃并计数
+ */
+class SessionRecorder : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SessionRecorder(QObject *parent = nullptr);
+    virtual ~SessionRecorder() override;
+
+    //在 start() 之前调用, 写入文件头
+    bool open(const QString &path, QString *perror = nullptr);
+    void append(const ElementRecord *records, int count);
+    void append(const QVector<ElementRecord> &records) { append(records.constData(), records.size()); }
+
+    quint64 recorded_records() const { return recorded_records_.load(); }
+    qint64 bytes_written() const { return bytes_written_.load(); }
+    int pending_high_water() const { return pending_high_water_.load(); }
+    quint64 dropped_records() const { return dropped_records_.load(); }
+
+signals:
+    void sig_error(const QString &message);
+
+public slots:
+    void start();
+    void flush();
+    //写完剩余记录、索引和文件尾后关闭文件
+    void close();
+
+private:
+    void write_chunk(const ElementRecord *records, int count);
+    void write_keyframe(qint64 timestamp);
+    void write_index();
+    bool write_block(quint32 tag, const void *head, int head_size, const void *body, int body_size);
+
+private:
+    QFile file_;
+    QTimer *ptimer_ = nullptr;
+
+    QMutex mutex_;
+    QVector<ElementRecord> pending_; //待写, 受 mutex_ 保护
+    QVector<ElementRecord> writing_; //写盘线程独占
+    std::atomic<bool> flush_requested_;
+
+    //写盘线程独占
+    QVector<SessionIndexEntry> index_entries_;
+    QVector<SessionIndexEntry> keyframe_entries_;
+    //每个 (类型, 主键) 的最新记录, 用于写关键帧; 删除记录把对应项移除, 末尾项补位
+    QVector<ElementRecord> latest_;
+    QHash<QPair<qint32, qint64>, int> map_latest_;
+    qint64 last_keyframe_ = -1;
+    qint64 last_index_ = -1;
+    qint64 first_timestamp_ = -1;
+    qint64 last_timestamp_ = -1;
+    bool failed_ = false;
+
+    std::atomic<quint64> recorded_records_;
+    std::atomic<qint64> bytes_written_;
+    std::atomic<int> pending_high_water_; //多个线程 append, 按比较交换取最大值
+    std::atomic<quint64> dropped_records_;
+};
+
+#endif //__SESSION_RECORDER_H__
@@ -0,0 +1,98 @@
+#include "telemetry_codec.h"
+
+#include <QtEndian>
+#include <cstring>
+
+//按字段逐个转换字节序, 网络序与主机序互转是同一操作
+static void swap_payload(const ElementDescriptor &desc, const char *in, char *out, bool to_host) {
+    for (int i = 0; i < desc.field_count; i++) {
+        switch (desc.fields[i].type) {
+            case VALUE_INT: {
+                quint32 value;
+                std::memcpy(&value, in, sizeof(value));
+                value = to_host ? qFromBigEndian(value) : qToBigEndian(value);
+                std::memcpy(out, &value, sizeof(value));
+                break;
+            }
+            case VALUE_DOUBLE: {
+                quint64 value;
+                std::memcpy(&value, in, sizeof(value));
+                value = to_host ? qFromBigEndian(value) : qToBigEndian(value);
+                std::memcpy(out, &value, sizeof(value));
+                break;
+            }
+            case VALUE_STRING:
+                std::memcpy(out, in, ELEMENT_STRING_SIZE);
+                out[ELEMENT_STRING_SIZE - 1] = '\0';
+                break;
+        }
+
+        int size = value_packed_size(desc.fields[i].type);
+        in += size;
+        out += size;
+    }
+}
+
+DecodeStatus TelemetryCodec::decode_frame(const char *data, int size, qint64 timestamp,
+                                          QVector<ElementRecord> *precords, int *pframe_size) {
+    // 1.校验帧头
+    if (size < TELEMETRY_HEADER_SIZE) return DECODE_TRUNCATED;
+
+    const uchar *head = reinterpret_cast<const uchar *>(data);
+    if (qFromBigEndian<quint16>(head) != TELEMETRY_MAGIC) return DECODE_BAD_MAGIC;
+    if (head[2] != TELEMETRY_VERSION) return DECODE_BAD_VERSION;
+
+    const ElementDescriptor *pdesc = element_descriptor(head[3]);
+    if (pdesc == Q_NULLPTR) return DECODE_BAD_TYPE;
+
+    int count = qFromBigEndian<quint16>(head + 4);
+    int record_size = qFromBigEndian<quint16>(head + 6);
+    if (record_size != element_packed_size(*pdesc) || count > TELEMETRY_MAX_RECORDS) return DECODE_BAD_LENGTH;
+
+    int frame_size = TELEMETRY_HEADER_SIZE + count * record_size;
+    if (size < frame_size) return DECODE_TRUNCATED;
+
+    // 2.逐条转换为主机字节序
+    qint32 flags = (qFromBigEndian<quint32>(head + 12) & TELEMETRY_FLAG_REMOVE) ? RECORD_REMOVED : 0;
+    const char *in = data + TELEMETRY_HEADER_SIZE;
+    int first = precords->size();
+    precords->resize(first + count);
+    for (int i = 0; i < count; i++) {
+        ElementRecord &record = (*precords)[first + i];
+        swap_payload(*pdesc, in, record.payload, true);
+        record.timestamp = timestamp;
+        record.type = pdesc->type;
+        record.flags = flags;
+        record.key = packed_key(*pdesc, record.payload);
+        in += record_size;
+    }
+
+    if (pframe_size != Q_NULLPTR) *pframe_size = frame_size;
+    return DECODE_OK;
+}
+
+QByteArray TelemetryCodec::encode_frame(ElementType type, const ElementRecord *records, int count,
+                                        quint32 sequence, quint32 flags) {
+    const ElementDescriptor *pdesc = element_descriptor(type);
+    if (pdesc == Q_NULLPTR || count < 0 || count > TELEMETRY_MAX_RECORDS) return QByteArray();
+
+    int record_size = element_packed_size(*pdesc);
+    QByteArray frame(TELEMETRY_HEADER_SIZE + count * record_size, '\0');
+
+    uchar *head = reinterpret_cast<uchar *>(frame.data());
+    qToBigEndian<quint16>(TELEMETRY_MAGIC, head);
+    head[2] = TELEMETRY_VERSION;
+    head[3] = static_cast<uchar>(type);
+    qToBigEndian<quint16>(static_cast<quint16>(count), head + 4);
+    qToBigEndian<quint16>(static_cast<quint16>(record_size), head + 6);
+    qToBigEndian<quint32>(sequence, head + 8);
+    qToBigEndian<quint32>(flags, head + 12);
+
+    char *out = frame.data() + TELEMETRY_HEADER_SIZE;
+    for (int i = 0; i < count; i++) {
+        swap_payload(*pdesc, records[i].payload, out, false);
+        out += record_size;
+    }
+
+    return frame;
+}
@@ -0,0 +1,54 @@
+#ifndef __TELEMETRY_CODEC_H__
+#define __TELEMETRY_CODEC_H__
+
+#include <QByteArray>
+#include <QVector>
+
+#include "src/models/element_record.h"
+
+/*
+ *  遥测帧格式(所有数值均为网络字节序):
+ *
+ *      帧头 16 字节
+ *          quint16 magic        固定为 TELEMETRY_MAGIC
+ *          quint8  version      固定为 TELEMETRY_VERSION
+ *          quint8  type         ElementType
+ *          quint16 count        记录条数
+ *          quint16 record_size  单条记录字节数, 必须等于该类型的紧凑长度
+ *          quint32 sequence     发送序号
+ *          quint32 flags        TELEMETRY_FLAG_REMOVE: 帧内记录均为删除, 只有主键字段有效
+ *      记录 count * record_size 字节
+ *          按描述表字段顺序排列: int32 / IEEE754 double / 32 字节 UTF-8 字符串
+ *
+ *  一个 UDP 报文携带一帧; 文件中多帧首尾相接
+ */
+const quint16 TELEMETRY_MAGIC = 0xEDC1;
+const quint8 TELEMETRY_VERSION = 1;
+const int TELEMETRY_HEADER_SIZE = 16;
+const int TELEMETRY_MAX_RECORDS = 4096; //单帧最多记录数
+const quint32 TELEMETRY_FLAG_REMOVE = 0x1;
+
+enum DecodeStatus {
+    DECODE_OK = 0,
+    DECODE_TRUNCATED,   //长度不足一个帧头或声明的记录
+    DECODE_BAD_MAGIC,
+    DECODE_BAD_VERSION,
+    DECODE_BAD_TYPE,
+    DECODE_BAD_LENGTH,  //记录长度或条数与类型不符
+};
+
+class TelemetryCodec {
+public:
+    /*
+     *  从 data 开头解码一帧, 校验通过后把记录追加到 precords
+     *  pframe_size 返回该帧占用的字节数, 用于在文件流中定位下一帧
+     */
+    static DecodeStatus decode_frame(const char *data, int size, qint64 timestamp, QVector<ElementRecord> *precords,
+                                     int *pframe_size = Q_NULLPTR);
+
+    //把同类型记录编码为一帧, 供模拟发送端和测试使用
+    static QByteArray encode_frame(ElementType type, const ElementRecord *records, int count, quint32 sequence,
+                                   quint32 flags = 0);
+};
+
+#endif //__TELEMETRY_CODEC_H__
@@ -0,0 +1,204 @@
+#include "telemetry_receiver.h"
+
+TelemetryReceiver::TelemetryReceiver(int ring_capacity, QObject *parent)
+    : QObject(parent),
+      ring_(ring_capacity),
+      notify_pending_(false),
+      decoded_records_(0),
+      rejected_frames_(0),
+      pushed_records_(0),
+      dropped_records_(0) {}
+
+TelemetryReceiver::~TelemetryReceiver() { stop(); }
+
+void TelemetryReceiver::set_udp_source(const QHostAddress &address, quint16 port) {
+    source_ = SOURCE_UDP;
+    address_ = address;
+    port_ = port;
+}
+
+void TelemetryReceiver::set_file_source(const QString &path, int frame_interval_ms) {
+    source_ = SOURCE_FILE;
+    file_path_ = path;
+    frame_interval_ms_ = frame_interval_ms;
+}
+
+void TelemetryReceiver::start() {
+    clock_.start();
+
+    //暂存区有数据时定时尝试补入队列
+    pflush_timer_ = new QTimer(this);
+    pflush_timer_->setSingleShot(true);
+    connect(pflush_timer_, &QTimer::timeout, this, &TelemetryReceiver::flush_overflow);
+
+    switch (source_) {
+        case SOURCE_UDP: {
+            psocket_ = new QUdpSocket(this);
+            if (!psocket_->bind(address_, port_)) {
+                emit sig_error(tr("无法绑定端口 %1: %2").arg(port_).arg(psocket_->errorString()));
+                return;
+            }
+            connect(psocket_, &QUdpSocket::readyRead, this, &TelemetryReceiver::on_ready_read);
+            break;
+        }
+        case SOURCE_FILE: {
+            pfile_ = new QFile(file_path_, this);
+            if (!pfile_->open(QFile::ReadOnly)) {
+                emit sig_error(tr("无法打开文件 %1").arg(file_path_));
+                return;
+            }
+            ptimer_ = new QTimer(this);
+            ptimer_->setTimerType(Qt::PreciseTimer);
+            connect(ptimer_, &QTimer::timeout, this, &TelemetryReceiver::on_file_timer);
+            ptimer_->start(frame_interval_ms_);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void TelemetryReceiver::stop() {
+    if (ptimer_ != nullptr) ptimer_->stop();
+    if (pflush_timer_ != nullptr) pflush_timer_->stop();
+    if (psocket_ != nullptr) psocket_->close();
+    if (pfile_ != nullptr) pfile_->close();
+}
+
+void TelemetryReceiver::on_ready_read() {
+    //一次读完所有排队的报文, 合并成一批交给界面线程
+    while (psocket_->hasPendingDatagrams()) {
+        datagram_.resize(static_cast<int>(psocket_->pendingDatagramSize()));
+        qint64 size = psocket_->readDatagram(datagram_.data(), datagram_.size());
+        if (size <= 0) continue;
+
+        //一个报文中可以首尾相接放多帧
+        const char *data = datagram_.constData();
+        int remain = static_cast<int>(size);
+        int frame_size = 0;
+        while (remain > 0 && decode(data, remain, &frame_size)) {
+            data += frame_size;
+            remain -= frame_size;
+        }
+    }
+
+    publish();
+}
+
+void TelemetryReceiver::on_file_timer() {
+    //每次定时回放一帧, 缓冲区不足一帧时从文件续读
+    int frame_size = 0;
+    for (;;) {
+        if (decode(file_buffer_.constData(), file_buffer_.size(), &frame_size)) {
+            file_buffer_.remove(0, frame_size);
+            break;
+        }
+        if (frame_size > 0) {
+            //坏帧无法确定长度, 逐字节向后查找下一个帧头
+            file_buffer_.remove(0, 1);
+            continue;
+        }
+
+        QByteArray chunk = pfile_->read(64 * 1024);
+        if (chunk.isEmpty()) {
+            ptimer_->stop();
+            break;
+        }
+        file_buffer_.append(chunk);
+    }
+
+    publish();
+}
+
+bool TelemetryReceiver::decode(const char *data, int size, int *pframe_size) {
+    *pframe_size = 0;
+    DecodeStatus status = TelemetryCodec::decode_frame(data, size, clock_.elapsed(), &batch_, pframe_size);
+
+    if (status == DECODE_OK) {
+        resyncing_ = false;
+        return true;
+    }
+
+    //文件流中数据不足一帧时继续读取, 其余情况视为坏帧, 连续的坏数据只计一次
+    if (status != DECODE_TRUNCATED || source_ == SOURCE_UDP) {
+        if (!resyncing_) rejected_frames_++;
+        resyncing_ = (source_ == SOURCE_FILE);
+        *pframe_size = 1;
+    }
+    return false;
+}
+
+void TelemetryReceiver::publish() {
+    if (batch_.isEmpty()) return;
+    decoded_records_ += batch_.size();
+    if (precorder_ != nullptr) precorder_->append(batch_);
+
+    //暂存区非空时新记录也进暂存区, 保证同一主键的先后顺序
+    flush_overflow();
+    for (const ElementRecord &record : batch_) {
+        if (overflow_.isEmpty() && ring_.try_push(record)) {
+            pushed_records_++;
+            continue;
+        }
+
+        if (policy_ == OVERFLOW_DROP_OLDEST) {
+            //丢弃一条最旧的再入队一次; 消费者正占用同一个槽时仍会失败, 不等待, 丢弃本条
+            ElementRecord oldest;
+            if (ring_.try_pop(&oldest)) dropped_records_++;
+            if (ring_.try_push(record))
+                pushed_records_++;
+            else
+                dropped_records_++;
+        } else {
+            auto var = overflow_.find(qMakePair(record.type, record.key));
+            if (var != overflow_.end()) {
+                var.value() = record;
+                dropped_records_++;
+            } else {
+                overflow_.insert(qMakePair(record.type, record.key), record);
+            }
+        }
+    }
+    batch_.clear();
+
+    if (!overflow_.isEmpty() && !pflush_timer_->isActive()) pflush_timer_->start(5);
+    if (!notify_pending_.exchange(true)) emit sig_ready();
+}
+
+void TelemetryReceiver::flush_overflow() {
+    if (overflow_.isEmpty()) return;
+
+    int count = 0;
+    auto var = overflow_.begin();
+    while (var != overflow_.end() && ring_.try_push(var.value())) {
+        var = overflow_.erase(var);
+        count++;
+    }
+    pushed_records_ += count;
+
+    if (!overflow_.isEmpty() && !pflush_timer_->isActive()) pflush_timer_->start(5);
+    if (count > 0 && !notify_pending_.exchange(true)) emit sig_ready();
+}
+
+int TelemetryReceiver::take_records(QVector<ElementRecord> *precords) {
+    //先清除通知标志, 之后入队的数据会再次通知
+    notify_pending_.store(false);
+
+    int count = 0;
+    ElementRecord record;
+    while (ring_.try_pop(&record)) {
+        precords->append(record);
+        count++;
+    }
+    return count;
+}
+
+RingStats TelemetryReceiver::ring_stats() const {
+    RingStats stats;
+    stats.capacity = ring_.capacity();
+    stats.size = ring_.size();
+    stats.high_water = ring_.high_water();
+    stats.pushed = pushed_records_.load();
+    stats.dropped = dropped_records_.load();
+    return stats;
+}
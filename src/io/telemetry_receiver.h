@@ -0,0 +1,111 @@
+#ifndef __TELEMETRY_RECEIVER_H__
+#define __TELEMETRY_RECEIVER_H__
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QPair>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+#include <atomic>
+
+#include "session_recorder.h"
+#include "src/utils/spsc_ring.h"
+#include "telemetry_codec.h"
+
+//队列满时的处理方式
+enum OverflowPolicy {
+    OVERFLOW_DROP_OLDEST = 0, //丢弃队列中最旧的记录
+    OVERFLOW_KEEP_LATEST,     //暂存到队列外, 同一主键只保留最新值, 队列有空位时补入
+};
+
+//队列统计
+struct RingStats {
+    int capacity;
+    int size;
+    int high_water;       //队列曾达到的最大长度
+    quint64 pushed;       //入队记录数
+    quint64 dropped;      //丢弃或被新值覆盖的记录数
+};
+
+/*
+ *  遥测接收与解码, 运行在独立的工作线程中
+ *  数据源为 UDP 端口或按帧回放的文件(用于本机模拟发送端)
+ *  解码结果写入有界无锁队列, 界面线程收到 sig_ready 后调用 take_records() 取走;
+ *  未取走之前不会再次发出通知, 事件循环中最多只有一个待处理的通知
+ */
+class TelemetryReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryReceiver(int ring_capacity = 16384, QObject *parent = nullptr);
+    virtual ~TelemetryReceiver() override;
+
+    //在 start() 之前设置数据源
+    void set_udp_source(const QHostAddress &address, quint16 port);
+    void set_file_source(const QString &path, int frame_interval_ms);
+    void set_overflow_policy(OverflowPolicy policy) { policy_ = policy; }
+    //解码后的全部记录同时交给记录器, 不受队列溢出影响
+    void set_recorder(SessionRecorder *precorder) { precorder_ = precorder; }
+
+    //界面线程调用, 取走队列中的全部记录, 返回取到的条数
+    int take_records(QVector<ElementRecord> *precords);
+    RingStats ring_stats() const;
+
+    quint64 decoded_records() const { return decoded_records_.load(); }
+    quint64 rejected_frames() const { return rejected_frames_.load(); }
+
+signals:
+    void sig_ready();
+    void sig_error(const QString &message);
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void on_ready_read();
+    void on_file_timer();
+    void flush_overflow();
+
+private:
+    bool decode(const char *data, int size, int *pframe_size);
+    void publish();
+
+private:
+    enum SourceType { SOURCE_NONE = 0, SOURCE_UDP, SOURCE_FILE };
+
+    SourceType source_ = SOURCE_NONE;
+    QHostAddress address_;
+    quint16 port_ = 0;
+    QString file_path_;
+    int frame_interval_ms_ = 10;
+
+    QUdpSocket *psocket_ = nullptr;
+    QFile *pfile_ = nullptr;
+    QTimer *ptimer_ = nullptr;
+    QByteArray datagram_;
+    QByteArray file_buffer_;
+    bool resyncing_ = false; //文件中正在跳过坏数据
+
+    QElapsedTimer clock_;             //记录时间戳使用的单调时钟
+    QVector<ElementRecord> batch_;    //本次解码的记录
+    SessionRecorder *precorder_ = nullptr;
+
+    //解码线程 -> 界面线程
+    SpscRing<ElementRecord> ring_;
+    OverflowPolicy policy_ = OVERFLOW_KEEP_LATEST;
+    QHash<QPair<qint32, qint64>, ElementRecord> overflow_; //队列满时暂存的最新值, 只在解码线程访问
+    QTimer *pflush_timer_ = nullptr;
+    std::atomic<bool> notify_pending_;
+
+    std::atomic<quint64> decoded_records_;
+    std::atomic<quint64> rejected_frames_;
+    std::atomic<quint64> pushed_records_;
+    std::atomic<quint64> dropped_records_;
+};
+
+#endif //__TELEMETRY_RECEIVER_H__
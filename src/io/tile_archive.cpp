@@ -0,0 +1,67 @@
+#include "tile_archive.h"
+
+#include <QObject>
+#include <algorithm>
+#include <cstring>
+
+bool TileArchive::open(const QString &path, QString *perror) {
+    close();
+
+    file_.setFileName(path);
+    if (!file_.open(QFile::ReadOnly)) {
+        if (perror != nullptr) *perror = file_.errorString();
+        return false;
+    }
+    map_size_ = file_.size();
+    pmap_ = (map_size_ >= static_cast<qint64>(sizeof(header_))) ? file_.map(0, map_size_) : nullptr;
+    if (pmap_ == nullptr) {
+        if (perror != nullptr) *perror = QObject::tr("不是瓦片归档文件");
+        close();
+        return false;
+    }
+
+    //索引紧凑排列且 8 字节对齐, 直接在映射区中查找
+    std::memcpy(&header_, pmap_, sizeof(header_));
+    QString error;
+    if (header_.magic != TILE_ARCHIVE_MAGIC) {
+        error = QObject::tr("不是瓦片归档文件");
+    } else if (header_.version != TILE_ARCHIVE_VERSION) {
+        error = QObject::tr("不支持的瓦片归档版本 %1").arg(header_.version);
+    } else if (header_.tile_size == 0 || header_.index_offset < static_cast<qint64>(sizeof(header_)) ||
+               header_.index_offset % alignof(TileArchiveEntry) != 0 ||
+               header_.index_offset + static_cast<qint64>(header_.tile_count) * sizeof(TileArchiveEntry) >
+                   map_size_) {
+        error = QObject::tr("瓦片归档索引已损坏");
+    }
+
+    if (!error.isEmpty()) {
+        if (perror != nullptr) *perror = error;
+        close();
+        return false;
+    }
+
+    pentries_ = reinterpret_cast<const TileArchiveEntry *>(pmap_ + header_.index_offset);
+    return true;
+}
+
+void TileArchive::close() {
+    if (pmap_ != nullptr) file_.unmap(pmap_);
+    pmap_ = nullptr;
+    map_size_ = 0;
+    pentries_ = nullptr;
+    std::memset(&header_, 0, sizeof(header_));
+    file_.close();
+}
+
+QByteArray TileArchive::tile(int z, int x, int y) const {
+    if (pentries_ == nullptr || z < header_.min_zoom || z > header_.max_zoom || x < 0 || y < 0) return QByteArray();
+
+    quint64 id = tile_archive_id(z, x, y);
+    const TileArchiveEntry *end = pentries_ + header_.tile_count;
+    const TileArchiveEntry *it = std::lower_bound(pentries_, end, id,
+                                                  [](const TileArchiveEntry &e, quint64 v) { return e.tile_id < v; });
+    if (it == end || it->tile_id != id) return QByteArray();
+    if (it->offset < header_.data_offset || it->offset > map_size_ - it->size) return QByteArray();
+
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(pmap_ + it->offset), it->size);
+}
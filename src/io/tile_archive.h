@@ -0,0 +1,43 @@
+#ifndef __TILE_ARCHIVE_H__
+#define __TILE_ARCHIVE_H__
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "tile_archive_format.h"
+#include "tile_source.h"
+
+/*
+ *  读取瓦片归档
+ *  整个文件只读映射到内存, 打开后不再有文件操作; 瓦片按编号二分查找, 数据直接引用映射区
+ *  打开后的所有查询都是只读的, 可在多个绘制线程中同时调用
+ */
+class TileArchive : public TileSource {
+public:
+    TileArchive() = default;
+    virtual ~TileArchive() override { close(); }
+
+    bool open(const QString &path, QString *perror = nullptr);
+    void close();
+    bool is_open() const { return pmap_ != nullptr; }
+
+    virtual int tile_size() const override { return header_.tile_size; }
+    virtual int min_zoom() const override { return header_.min_zoom; }
+    virtual int max_zoom() const override { return header_.max_zoom; }
+    int tile_count() const { return header_.tile_count; }
+
+    //瓦片的 PNG 数据, 不复制, 在 close() 之前有效; 不存在时返回空
+    virtual QByteArray tile(int z, int x, int y) const override;
+
+private:
+    Q_DISABLE_COPY(TileArchive)
+
+    QFile file_;
+    uchar *pmap_ = nullptr;
+    qint64 map_size_ = 0;
+    TileArchiveHeader header_ = {};
+    const TileArchiveEntry *pentries_ = nullptr;
+};
+
+#endif //__TILE_ARCHIVE_H__
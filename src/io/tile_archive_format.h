@@ -0,0 +1,48 @@
+#ifndef __TILE_ARCHIVE_FORMAT_H__
+#define __TILE_ARCHIVE_FORMAT_H__
+
+#include <QtGlobal>
+
+/*
+ *  瓦片归档文件格式(主机字节序, 小端):
+ *
+ *      文件头 TileArchiveHeader
+ *      索引   tile_count 个 TileArchiveEntry, 按 tile_id 升序, 位于 index_offset
+ *      数据   各瓦片的原始 PNG 文件内容, 按索引顺序首尾相接, 从 data_offset 开始
+ *
+ *  瓦片按 XYZ 编号(左上角为原点, 与 resouces/Tiles/{z}/{x}/{y}.png 一致)
+ *  文件由 tools/tile_packer 一次写成, 之后只读
+ */
+#define TILE_ARCHIVE_TAG(a, b, c, d) (quint32(a) | (quint32(b) << 8) | (quint32(c) << 16) | (quint32(d) << 24))
+
+const quint32 TILE_ARCHIVE_MAGIC = TILE_ARCHIVE_TAG('E', 'D', 'T', 'A');
+const quint16 TILE_ARCHIVE_VERSION = 1;
+
+struct TileArchiveHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 tile_size; //瓦片边长, 像素
+    quint8 min_zoom;
+    quint8 max_zoom;
+    quint16 reserved;
+    quint32 tile_count;
+    qint64 index_offset;
+    qint64 data_offset;
+};
+
+struct TileArchiveEntry {
+    quint64 tile_id; //见 tile_archive_id()
+    qint64 offset;   // PNG 数据的文件偏移
+    quint32 size;
+    quint32 reserved;
+};
+
+static_assert(sizeof(TileArchiveHeader) == 32, "TileArchiveHeader layout");
+static_assert(sizeof(TileArchiveEntry) == 24, "TileArchiveEntry layout");
+
+//按 (z, x, y) 排序的瓦片编号, 每级 x, y 各占 28 位
+inline quint64 tile_archive_id(int z, int x, int y) {
+    return (quint64(z) << 56) | (quint64(x) << 28) | quint64(y);
+}
+
+#endif //__TILE_ARCHIVE_FORMAT_H__
@@ -0,0 +1,37 @@
+#include "tile_directory.h"
+
+#include <QDir>
+#include <QFile>
+#include <QObject>
+
+bool TileDirectory::open(const QString &path, int tile_size, QString *perror) {
+    min_zoom_ = 255;
+    max_zoom_ = -1;
+
+    QDir dir(path);
+    for (const QString &name : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool ok = false;
+        int z = name.toInt(&ok);
+        if (!ok || z < 0 || z > 30) continue;
+        min_zoom_ = qMin(min_zoom_, z);
+        max_zoom_ = qMax(max_zoom_, z);
+    }
+
+    if (max_zoom_ < 0) {
+        min_zoom_ = 0;
+        if (perror != nullptr) *perror = QObject::tr("%1 中没有瓦片层级目录").arg(path);
+        return false;
+    }
+
+    path_ = dir.absolutePath();
+    tile_size_ = tile_size;
+    return true;
+}
+
+QByteArray TileDirectory::tile(int z, int x, int y) const {
+    if (z < min_zoom_ || z > max_zoom_) return QByteArray();
+
+    QFile file(QString("%1/%2/%3/%4.png").arg(path_).arg(z).arg(x).arg(y));
+    if (!file.open(QFile::ReadOnly)) return QByteArray();
+    return file.readAll();
+}
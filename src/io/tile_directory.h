@@ -0,0 +1,28 @@
+#ifndef __TILE_DIRECTORY_H__
+#define __TILE_DIRECTORY_H__
+
+#include <QString>
+
+#include "tile_source.h"
+
+/*
+ *  按 {z}/{x}/{y}.png 存放的瓦片目录, 没有打包时使用
+ *  层级范围在打开时由一级子目录得到, 瓦片按需逐个读取
+ */
+class TileDirectory : public TileSource {
+public:
+    bool open(const QString &path, int tile_size = 256, QString *perror = nullptr);
+
+    virtual int tile_size() const override { return tile_size_; }
+    virtual int min_zoom() const override { return min_zoom_; }
+    virtual int max_zoom() const override { return max_zoom_; }
+    virtual QByteArray tile(int z, int x, int y) const override;
+
+private:
+    QString path_;
+    int tile_size_ = 256;
+    int min_zoom_ = 0;
+    int max_zoom_ = -1;
+};
+
+#endif //__TILE_DIRECTORY_H__
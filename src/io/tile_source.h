@@ -0,0 +1,21 @@
+#ifndef __TILE_SOURCE_H__
+#define __TILE_SOURCE_H__
+
+#include <QByteArray>
+
+/*
+ *  XYZ 瓦片来源(左上角为原点), 返回未解码的图片数据
+ *  打开后的查询必须是只读的, 绘制线程会同时调用
+ */
+class TileSource {
+public:
+    virtual ~TileSource() {}
+
+    virtual int tile_size() const = 0;
+    virtual int min_zoom() const = 0;
+    virtual int max_zoom() const = 0;
+    //不存在时返回空
+    virtual QByteArray tile(int z, int x, int y) const = 0;
+};
+
+#endif //__TILE_SOURCE_H__
@@ -1,11 +1,13 @@
 #include <QApplication>
 #include "src/views/mainwindow.h"
 #include "qgsapplication.h"
+#include "src/map/xyz_tile_provider.h"
 
 int main(int argc, char *argv[]) {
     QgsApplication a(argc, argv,true);
     QgsApplication::setPrefixPath("C:/qgis3.4.9_vs2017_qt5.12.4", true);
     QgsApplication::initQgis();
+    XyzTileProvider::register_provider();
     MainWindow w;
     w.showMaximized();
     return a.exec();
@@ -0,0 +1,209 @@
+#include "raw_tile_cache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+
+#include "src/utils/function_runnable.h"
+
+const quint32 RAW_TILE_MAGIC = 0x54524445; // "EDRT"
+const quint16 RAW_TILE_VERSION = 2;
+//排队等待写入的瓦片上限, 快速平移时大量未命中, 写不过来的直接放弃, 下次未命中时再写
+const int MAX_PENDING_WRITES = 64;
+//命中时刷新修改时间的最小间隔, 秒
+const qint64 TOUCH_INTERVAL = 600;
+
+//文件头之后为 height 行像素, 每行 bytes_per_line 字节, 与 QImage 的内存布局一致
+struct RawTileHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 format; // QImage::Format
+    quint32 width;
+    quint32 height;
+    quint32 bytes_per_line;
+    quint32 reserved;
+};
+static_assert(sizeof(RawTileHeader) == 24, "RawTileHeader layout");
+
+RawTileCache &RawTileCache::instance() {
+    //局部静态变量的初始化是线程安全的
+    static RawTileCache cache;
+    return cache;
+}
+
+RawTileCache::RawTileCache()
+    : budget_(1024LL * 1024 * 1024), used_bytes_(-1), hits_(0), misses_(0), dropped_stores_(0) {
+    //单线程顺序写入, 不与绘制线程争抢磁盘
+    writer_.setMaxThreadCount(1);
+}
+
+void RawTileCache::set_directory(const QString &path) {
+    QMutexLocker locker(&mutex_);
+    directory_ = path.isEmpty() ? QString() : QDir(path).absolutePath();
+    used_bytes_ = -1;
+}
+
+bool RawTileCache::is_enabled() const {
+    QMutexLocker locker(&mutex_);
+    return !directory_.isEmpty();
+}
+
+QString RawTileCache::source_id(const QString &uri) {
+    QFileInfo info(uri);
+    QByteArray text = info.absoluteFilePath().toUtf8() + '|' +
+                      QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+    return QString::fromLatin1(QCryptographicHash::hash(text, QCryptographicHash::Md5).toHex().left(16));
+}
+
+QString RawTileCache::file_path(const QString &source, int z, int x, int y) const {
+    QMutexLocker locker(&mutex_);
+    if (directory_.isEmpty()) return QString();
+    return QString("%1/%2/%3/%4/%5.raw").arg(directory_).arg(source).arg(z).arg(x).arg(y);
+}
+
+QImage RawTileCache::load(const QString &source, int z, int x, int y) {
+    QString path = file_path(source, z, x, y);
+    if (path.isEmpty()) return QImage();
+
+    QFile file(path);
+    RawTileHeader head;
+    if (!file.open(QFile::ReadOnly) ||
+        file.read(reinterpret_cast<char *>(&head), sizeof(head)) != static_cast<qint64>(sizeof(head)) ||
+        head.magic != RAW_TILE_MAGIC || head.version != RAW_TILE_VERSION || head.width == 0 || head.height == 0 ||
+        head.width > 4096 || head.height > 4096) {
+        misses_++;
+        return QImage();
+    }
+
+    //格式或行长度与本机 QImage 不一致时视为未命中, 之后由 PNG 重新生成
+    QImage::Format format = static_cast<QImage::Format>(head.format);
+    if (format != QImage::Format_RGB888 && format != QImage::Format_ARGB32_Premultiplied) {
+        misses_++;
+        return QImage();
+    }
+    QImage image(head.width, head.height, format);
+    qint64 size = static_cast<qint64>(head.bytes_per_line) * head.height;
+    if (image.isNull() || image.bytesPerLine() != static_cast<int>(head.bytes_per_line) ||
+        file.read(reinterpret_cast<char *>(image.bits()), size) != size) {
+        misses_++;
+        return QImage();
+    }
+
+    //淘汰按修改时间进行, 常用的瓦片隔一段时间刷新一次
+    QDateTime now = QDateTime::currentDateTime();
+    if (file.fileTime(QFileDevice::FileModificationTime).secsTo(now) > TOUCH_INTERVAL)
+        file.setFileTime(now, QFileDevice::FileModificationTime);
+
+    hits_++;
+    return (format == QImage::Format_ARGB32_Premultiplied) ? image
+                                                           : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+void RawTileCache::store(const QString &source, int z, int x, int y, const QImage &image) {
+    QString path = file_path(source, z, x, y);
+    if (path.isEmpty() || image.isNull()) return;
+
+    {
+        QMutexLocker locker(&mutex_);
+        if (pending_.contains(path)) return;
+        if (pending_.size() >= MAX_PENDING_WRITES) {
+            dropped_stores_++;
+            return;
+        }
+        pending_.insert(path);
+    }
+    //图像隐式共享, 写入线程持有的是只读副本
+    writer_.start(new FunctionRunnable([=] { write(path, image); }));
+}
+
+//所有像素的 alpha 都是 255
+static bool is_opaque(const QImage &image) {
+    if (!image.hasAlphaChannel()) return true;
+    if (image.format() != QImage::Format_ARGB32_Premultiplied && image.format() != QImage::Format_ARGB32)
+        return false;
+
+    for (int y = 0; y < image.height(); y++) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); x++) {
+            if (qAlpha(line[x]) != 255) return false;
+        }
+    }
+    return true;
+}
+
+void RawTileCache::write(const QString &path, const QImage &image) {
+    //只在未命中后写入, 已有的文件是旧版本或已损坏, 直接替换
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    qint64 old_size = QFileInfo(path).size();
+
+    //底图瓦片多为不透明, 去掉 alpha 后文件小四分之一
+    QImage stored = is_opaque(image) ? image.convertToFormat(QImage::Format_RGB888) : image;
+
+    RawTileHeader head;
+    head.magic = RAW_TILE_MAGIC;
+    head.version = RAW_TILE_VERSION;
+    head.format = static_cast<quint16>(stored.format());
+    head.width = stored.width();
+    head.height = stored.height();
+    head.bytes_per_line = stored.bytesPerLine();
+    head.reserved = 0;
+
+    qint64 size = static_cast<qint64>(stored.bytesPerLine()) * stored.height();
+    QSaveFile file(path);
+    if (file.open(QFile::WriteOnly) &&
+        file.write(reinterpret_cast<const char *>(&head), sizeof(head)) == static_cast<qint64>(sizeof(head)) &&
+        file.write(reinterpret_cast<const char *>(stored.constBits()), size) == size && file.commit()) {
+        if (used_bytes_ >= 0) used_bytes_ += static_cast<qint64>(sizeof(head)) + size - old_size;
+    }
+
+    {
+        QMutexLocker locker(&mutex_);
+        pending_.remove(path);
+    }
+    trim();
+}
+
+void RawTileCache::trim() {
+    //超出上限时统计目录并按修改时间删除最旧的文件, 降到上限的 90% 为止, 不必每次写入都扫描目录
+    qint64 budget = budget_.load();
+    if (budget <= 0 || (used_bytes_ >= 0 && used_bytes_ <= budget)) return;
+
+    QString root;
+    {
+        QMutexLocker locker(&mutex_);
+        root = directory_;
+    }
+    if (root.isEmpty()) return;
+
+    struct Entry {
+        qint64 mtime;
+        qint64 size;
+        QString path;
+    };
+    QVector<Entry> entries;
+    qint64 used = 0;
+    QDirIterator it(root, QStringList() << "*.raw", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        entries.append({info.lastModified().toMSecsSinceEpoch(), info.size(), info.filePath()});
+        used += info.size();
+    }
+
+    if (used > budget) {
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.mtime < b.mtime; });
+        qint64 target = budget - budget / 10;
+        for (const Entry &entry : entries) {
+            if (used <= target) break;
+            if (QFile::remove(entry.path)) used -= entry.size;
+        }
+    }
+    used_bytes_ = used;
+}
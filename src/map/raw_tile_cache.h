@@ -0,0 +1,61 @@
+#ifndef __RAW_TILE_CACHE_H__
+#define __RAW_TILE_CACHE_H__
+
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+
+/*
+ *  解码后瓦片的磁盘缓存, 作为 TileCache 之后、PNG 解码之前的第二级缓存
+ *  每个瓦片一个文件 <目录>/<数据源>/<z>/<x>/<y>.raw, 内容为小文件头加原样的像素行,
+ *  读取时一次读入 QImage 缓冲区, 不需要解码; 不透明的瓦片去掉 alpha 按 RGB888 保存, 读取后展开为绘制格式
+ *  写入在单独的后台线程中顺序进行, 先写临时文件再改名, 读取方不会看到写了一半的文件;
+ *  排队的写入过多时新的写入直接放弃, 总大小超出上限时按修改时间删除最旧的文件, 命中时刷新修改时间
+ */
+class RawTileCache {
+public:
+    static RawTileCache &instance();
+
+    //缓存目录, 为空时关闭磁盘缓存(默认)
+    void set_directory(const QString &path);
+    bool is_enabled() const;
+    //磁盘占用上限, 字节, 0 表示不限制; 默认 1GB
+    void set_budget(qint64 bytes) { budget_ = bytes; }
+    qint64 budget() const { return budget_.load(); }
+
+    // source 区分不同数据源, 见 source_id(); 未命中时返回空图像
+    QImage load(const QString &source, int z, int x, int y);
+    //后台写入, 同一瓦片正在写入或排队的写入超过 MAX_PENDING_WRITES 时忽略
+    void store(const QString &source, int z, int x, int y, const QImage &image);
+
+    //数据源标识: 路径和修改时间的摘要, 归档重新生成后旧缓存自动失效
+    static QString source_id(const QString &uri);
+
+    quint64 hits() const { return hits_.load(); }
+    quint64 misses() const { return misses_.load(); }
+    quint64 dropped_stores() const { return dropped_stores_.load(); }
+
+private:
+    RawTileCache();
+    Q_DISABLE_COPY(RawTileCache)
+
+    QString file_path(const QString &source, int z, int x, int y) const;
+    void write(const QString &path, const QImage &image);
+    void trim();
+
+private:
+    mutable QMutex mutex_;
+    QString directory_;
+    QSet<QString> pending_; //排队和正在写入的文件
+    QThreadPool writer_;
+    std::atomic<qint64> budget_;
+    std::atomic<qint64> used_bytes_; //目录下 .raw 文件的总大小, -1 表示尚未统计; 只在写入线程中更新
+    std::atomic<quint64> hits_;
+    std::atomic<quint64> misses_;
+    std::atomic<quint64> dropped_stores_;
+};
+
+#endif //__RAW_TILE_CACHE_H__
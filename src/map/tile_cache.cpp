@@ -0,0 +1,60 @@
+#include "tile_cache.h"
+
+#include <QMutexLocker>
+#include <climits>
+
+//默认缓存上限, 约可容纳 1000 个 256 x 256 的瓦片
+static const qint64 DEFAULT_BUDGET = 256LL * 1024 * 1024;
+
+TileCache &TileCache::instance() {
+    //局部静态变量的初始化是线程安全的
+    static TileCache cache;
+    return cache;
+}
+
+TileCache::TileCache() : hits_(0), misses_(0) { set_budget(DEFAULT_BUDGET); }
+
+void TileCache::set_budget(qint64 bytes) {
+    QMutexLocker locker(&mutex_);
+    cache_.setMaxCost(static_cast<int>(qBound<qint64>(1, bytes / 1024, INT_MAX)));
+}
+
+qint64 TileCache::budget() const {
+    QMutexLocker locker(&mutex_);
+    return cache_.maxCost() * 1024LL;
+}
+
+qint64 TileCache::used() const {
+    QMutexLocker locker(&mutex_);
+    return cache_.totalCost() * 1024LL;
+}
+
+QImage TileCache::find(const Key &key) {
+    //QCache::object() 会把命中项移到最近使用的位置, 图像隐式共享, 复制代价很小
+    QMutexLocker locker(&mutex_);
+    QImage *pimage = cache_.object(key);
+    if (pimage == nullptr) {
+        misses_++;
+        return QImage();
+    }
+    hits_++;
+    return *pimage;
+}
+
+bool TileCache::contains(const Key &key) const {
+    QMutexLocker locker(&mutex_);
+    return cache_.contains(key);
+}
+
+void TileCache::insert(const Key &key, const QImage &image) {
+    if (image.isNull()) return;
+    int cost = static_cast<int>(qMax<qint64>(1, image.sizeInBytes() / 1024));
+
+    QMutexLocker locker(&mutex_);
+    cache_.insert(key, new QImage(image), cost);
+}
+
+void TileCache::clear() {
+    QMutexLocker locker(&mutex_);
+    cache_.clear();
+}
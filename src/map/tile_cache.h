@@ -0,0 +1,47 @@
+#ifndef __TILE_CACHE_H__
+#define __TILE_CACHE_H__
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <atomic>
+
+/*
+ *  解码后瓦片的内存缓存, 进程内所有地图画布和绘制线程共用
+ *  按 (数据源, z, x, y) 索引, 按图像字节数计入预算, 超出时淘汰最久未使用的瓦片
+ */
+class TileCache {
+public:
+    typedef QPair<QString, quint64> Key; //数据源地址, tile_archive_id()
+
+    static TileCache &instance();
+
+    //缓存上限, 字节; 缩小时立即淘汰
+    void set_budget(qint64 bytes);
+    qint64 budget() const;
+    qint64 used() const;
+
+    //未命中时返回空图像
+    QImage find(const Key &key);
+    //不改变使用顺序, 也不计入命中或未命中
+    bool contains(const Key &key) const;
+    void insert(const Key &key, const QImage &image);
+    void clear();
+
+    quint64 hits() const { return hits_.load(); }
+    quint64 misses() const { return misses_.load(); }
+
+private:
+    TileCache();
+    Q_DISABLE_COPY(TileCache)
+
+private:
+    mutable QMutex mutex_;
+    QCache<Key, QImage> cache_; //代价以 KB 计, 避免大预算超出 int 范围
+    std::atomic<quint64> hits_;
+    std::atomic<quint64> misses_;
+};
+
+#endif //__TILE_CACHE_H__
@@ -0,0 +1,50 @@
+#include "tile_loader.h"
+
+#include <cmath>
+
+#include "raw_tile_cache.h"
+#include "src/io/tile_archive_format.h"
+#include "tile_cache.h"
+
+TileLoader::TileLoader(const QString &uri, const QSharedPointer<const TileSource> &source)
+    : uri_(uri), source_id_(RawTileCache::source_id(uri)), source_(source) {}
+
+int TileLoader::zoom_for(double resolution) const {
+    int zoom = static_cast<int>(
+        std::ceil(std::log2(2.0 * TILE_WORLD_HALF / (source_->tile_size() * resolution)) - 0.01));
+    return qBound(source_->min_zoom(), zoom, source_->max_zoom());
+}
+
+TileRange TileLoader::tile_range(const QgsRectangle &extent, int zoom) {
+    int tiles = 1 << zoom;
+    double span = tile_span(zoom);
+
+    TileRange range;
+    range.zoom = zoom;
+    range.first_x = qBound(0, static_cast<int>(std::floor((extent.xMinimum() + TILE_WORLD_HALF) / span)), tiles - 1);
+    range.last_x = qBound(0, static_cast<int>(std::floor((extent.xMaximum() + TILE_WORLD_HALF) / span)), tiles - 1);
+    range.first_y = qBound(0, static_cast<int>(std::floor((TILE_WORLD_HALF - extent.yMaximum()) / span)), tiles - 1);
+    range.last_y = qBound(0, static_cast<int>(std::floor((TILE_WORLD_HALF - extent.yMinimum()) / span)), tiles - 1);
+    return range;
+}
+
+QImage TileLoader::image(int z, int x, int y) const {
+    TileCache::Key key(uri_, tile_archive_id(z, x, y));
+    QImage image = TileCache::instance().find(key);
+    if (!image.isNull()) return image;
+
+    //磁盘缓存返回的已是绘制用的格式; 都未命中时解码 PNG 并转换格式, 不存在的瓦片不缓存
+    RawTileCache &raw = RawTileCache::instance();
+    image = raw.load(source_id_, z, x, y);
+    if (image.isNull()) {
+        if (!image.loadFromData(source_->tile(z, x, y), "PNG")) return QImage();
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        raw.store(source_id_, z, x, y, image);
+    }
+    TileCache::instance().insert(key, image);
+    return image;
+}
+
+bool TileLoader::is_cached(int z, int x, int y) const {
+    return TileCache::instance().contains(TileCache::Key(uri_, tile_archive_id(z, x, y)));
+}
@@ -0,0 +1,54 @@
+#ifndef __TILE_LOADER_H__
+#define __TILE_LOADER_H__
+
+#include <QImage>
+#include <QSharedPointer>
+#include <QString>
+
+#include <qgsrectangle.h>
+
+#include "src/io/tile_source.h"
+
+//Web 墨卡托全球范围的一半, 米
+const double TILE_WORLD_HALF = 20037508.342789244;
+
+//一个层级中的瓦片行列范围, 行号从上往下
+struct TileRange {
+    int zoom;
+    int first_x;
+    int last_x;
+    int first_y;
+    int last_y;
+};
+
+/*
+ *  按 (z, x, y) 取解码后的瓦片: 依次查 TileCache、RawTileCache, 都未命中时解码并写入两级缓存
+ *  只保存共享的瓦片来源和标识, 按值复制, 可在绘制线程和预取线程中同时使用
+ */
+class TileLoader {
+public:
+    TileLoader() = default;
+    TileLoader(const QString &uri, const QSharedPointer<const TileSource> &source);
+
+    bool is_valid() const { return !source_.isNull(); }
+    const TileSource *source() const { return source_.data(); }
+    const QString &uri() const { return uri_; }
+
+    //分辨率(米/像素)不低于 resolution 的层级, 限制在数据源的层级范围内
+    int zoom_for(double resolution) const;
+    //覆盖 extent 的瓦片范围, 超出全球范围的部分截去
+    static TileRange tile_range(const QgsRectangle &extent, int zoom);
+    //瓦片边长, 米
+    static double tile_span(int zoom) { return 2.0 * TILE_WORLD_HALF / (1 << zoom); }
+
+    QImage image(int z, int x, int y) const;
+    //是否已在内存缓存中, 不影响缓存的使用顺序和计数
+    bool is_cached(int z, int x, int y) const;
+
+private:
+    QString uri_;
+    QString source_id_; //磁盘缓存中的数据源标识
+    QSharedPointer<const TileSource> source_;
+};
+
+#endif //__TILE_LOADER_H__
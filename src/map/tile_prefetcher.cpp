@@ -0,0 +1,198 @@
+#include "tile_prefetcher.h"
+
+#include <QMouseEvent>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+
+#include <qgscoordinatereferencesystem.h>
+
+#include "src/io/tile_archive_format.h"
+#include "src/utils/function_runnable.h"
+
+//默认预取预算, 约 128 个 256 x 256 的瓦片
+static const qint64 DEFAULT_BUDGET = 32LL * 1024 * 1024;
+//按速度外推的时间, 秒
+static const double LOOKAHEAD_S = 0.5;
+//拖动中两次预测的最小间隔, 毫秒
+static const qint64 PREFETCH_INTERVAL_MS = 50;
+//速度平滑系数, 越大越依赖历史速度
+static const double VELOCITY_SMOOTHING = 0.5;
+
+TilePrefetcher::TilePrefetcher(QgsMapCanvas *pcanvas, const TileLoader &loader, QObject *parent)
+    : QObject(parent), pcanvas_(pcanvas), loader_(loader), budget_(DEFAULT_BUDGET), generation_(0), prefetched_(0) {
+    //留一个核给界面线程, 绘制线程与预取线程共用其余的核
+    pool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    clock_.start();
+    last_resolution_ = pcanvas_->mapUnitsPerPixel();
+
+    //拖动时画布不改变范围, 从视口的鼠标事件推算
+    pcanvas_->viewport()->installEventFilter(this);
+    connect(pcanvas_, &QgsMapCanvas::extentsChanged, this, &TilePrefetcher::on_extent_changed);
+}
+
+TilePrefetcher::~TilePrefetcher() {
+    //作废所有排队的任务, 等待正在执行的任务结束
+    generation_++;
+    pool_.clear();
+    pool_.waitForDone();
+}
+
+bool TilePrefetcher::eventFilter(QObject *o, QEvent *e) {
+    if (o != pcanvas_->viewport()) return QObject::eventFilter(o, e);
+
+    switch (e->type()) {
+        case QEvent::MouseButtonPress: {
+            QMouseEvent *pevent = static_cast<QMouseEvent *>(e);
+            if (pevent->button() != Qt::LeftButton && pevent->button() != Qt::MidButton) break;
+            dragging_ = true;
+            drag_origin_ = pevent->pos();
+            drag_extent_ = pcanvas_->extent();
+            last_center_ = QPointF(drag_extent_.center().x(), drag_extent_.center().y());
+            last_ms_ = clock_.elapsed();
+            velocity_ = QPointF();
+            break;
+        }
+        case QEvent::MouseMove: {
+            if (!dragging_) break;
+
+            // 1.拖动偏移换算为当前可见范围, 向右拖动时看到的是西侧
+            QMouseEvent *pevent = static_cast<QMouseEvent *>(e);
+            QPoint offset = pevent->pos() - drag_origin_;
+            double resolution = pcanvas_->mapUnitsPerPixel();
+            double dx = offset.x() * resolution;
+            double dy = offset.y() * resolution;
+            QgsRectangle extent(drag_extent_.xMinimum() - dx, drag_extent_.yMinimum() + dy,
+                                drag_extent_.xMaximum() - dx, drag_extent_.yMaximum() + dy);
+
+            // 2.每隔 PREFETCH_INTERVAL_MS 更新一次速度并预测
+            if (!update_velocity(QPointF(extent.center().x(), extent.center().y()))) break;
+            prefetch(extent, velocity_, 0);
+            break;
+        }
+        case QEvent::MouseButtonRelease:
+            dragging_ = false;
+            break;
+        default:
+            break;
+    }
+    return QObject::eventFilter(o, e);
+}
+
+bool TilePrefetcher::update_velocity(const QPointF &center) {
+    qint64 now = clock_.elapsed();
+    qint64 dt = now - last_ms_;
+    if (dt < PREFETCH_INTERVAL_MS) return false;
+
+    //停顿较久后不再沿用历史速度
+    QPointF velocity = (center - last_center_) * (1000.0 / dt);
+    if (dt > 10 * PREFETCH_INTERVAL_MS)
+        velocity_ = velocity;
+    else
+        velocity_ = velocity_ * VELOCITY_SMOOTHING + velocity * (1.0 - VELOCITY_SMOOTHING);
+    last_center_ = center;
+    last_ms_ = now;
+    return true;
+}
+
+void TilePrefetcher::on_extent_changed() {
+    double resolution = pcanvas_->mapUnitsPerPixel();
+    int zoom_dir = 0;
+    if (resolution < last_resolution_ * 0.99)
+        zoom_dir = 1;
+    else if (resolution > last_resolution_ * 1.01)
+        zoom_dir = -1;
+    last_resolution_ = resolution;
+
+    //刚结束拖动时认为会继续向同一方向平移
+    bool recent_drag = zoom_dir == 0 && clock_.elapsed() - last_ms_ < 10 * PREFETCH_INTERVAL_MS;
+    prefetch(pcanvas_->extent(), recent_drag ? velocity_ : QPointF(), zoom_dir);
+}
+
+void TilePrefetcher::prefetch(const QgsRectangle &extent, const QPointF &velocity, int zoom_dir) {
+    if (!loader_.is_valid() || budget_ <= 0) return;
+    //画布未设置坐标系时不重投影, 与瓦片坐标一致
+    QgsCoordinateReferenceSystem crs = pcanvas_->mapSettings().destinationCrs();
+    if (crs.isValid() && crs.authid() != QStringLiteral("EPSG:3857")) return;
+
+    struct Candidate {
+        int z;
+        int x;
+        int y;
+        double distance; //瓦片中心到预测中心的距离
+    };
+    QVector<Candidate> candidates;
+    const TileSource *psource = loader_.source();
+
+    //预测中心: 当前中心沿速度外推
+    QPointF shift = velocity * LOOKAHEAD_S;
+    QPointF focus(extent.center().x() + shift.x(), extent.center().y() + shift.y());
+    auto add_range = [&](const TileRange &range) {
+        double span = TileLoader::tile_span(range.zoom);
+        for (int y = range.first_y; y <= range.last_y; y++) {
+            for (int x = range.first_x; x <= range.last_x; x++) {
+                if (loader_.is_cached(range.zoom, x, y)) continue;
+                QPointF center((x + 0.5) * span - TILE_WORLD_HALF, TILE_WORLD_HALF - (y + 0.5) * span);
+                QPointF d = center - focus;
+                candidates.append({range.zoom, x, y, d.x() * d.x() + d.y() * d.y()});
+            }
+        }
+    };
+
+    // 1.当前层级: 可见范围外扩一圈瓦片, 并覆盖沿速度外推后的范围
+    int zoom = loader_.zoom_for(pcanvas_->mapUnitsPerPixel());
+    QgsRectangle area = extent;
+    area.grow(TileLoader::tile_span(zoom));
+    area.combineExtentWith(QgsRectangle(extent.xMinimum() + shift.x(), extent.yMinimum() + shift.y(),
+                                        extent.xMaximum() + shift.x(), extent.yMaximum() + shift.y()));
+    add_range(TileLoader::tile_range(area, zoom));
+
+    // 2.按缩放方向预取下一层级: 放大时取中心一半的范围, 缩小时取两倍范围
+    int next = zoom + zoom_dir;
+    if (zoom_dir != 0 && next >= psource->min_zoom() && next <= psource->max_zoom()) {
+        QgsRectangle scaled = extent;
+        scaled.scale(zoom_dir > 0 ? 0.5 : 2.0);
+        add_range(TileLoader::tile_range(scaled, next));
+    }
+
+    // 3.由近到远排队, 所有排队和解码中的瓦片合计超出预算时不再排队
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b) { return a.distance < b.distance; });
+    qint64 tile_bytes = 4LL * psource->tile_size() * psource->tile_size();
+
+    //已排队的瓦片只更新预测序号, 不重复排队也不重复计入预算; 任务执行时按瓦片当前的序号判断是否仍被需要
+    int generation = ++generation_;
+    TileLoader loader = loader_;
+    for (const Candidate &tile : candidates) {
+        quint64 id = tile_archive_id(tile.z, tile.x, tile.y);
+        {
+            QMutexLocker locker(&mutex_);
+            auto var = queued_.find(id);
+            if (var != queued_.end()) {
+                var.value() = generation;
+                continue;
+            }
+            //预算已满时仍要继续, 刷新更远处已排队瓦片的序号
+            if (inflight_bytes_ + tile_bytes > budget_) continue;
+            queued_.insert(id, generation);
+            inflight_bytes_ += tile_bytes;
+        }
+
+        pool_.start(new FunctionRunnable([=] {
+            //最近一次预测不再需要的瓦片直接放弃
+            bool wanted;
+            {
+                QMutexLocker locker(&mutex_);
+                wanted = queued_.value(id, -1) == generation_;
+            }
+            if (wanted && !loader.is_cached(tile.z, tile.x, tile.y) &&
+                !loader.image(tile.z, tile.x, tile.y).isNull())
+                prefetched_++;
+
+            QMutexLocker locker(&mutex_);
+            queued_.remove(id);
+            inflight_bytes_ -= tile_bytes;
+        }));
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef __TILE_PREFETCHER_H__
+#define __TILE_PREFETCHER_H__
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPoint>
+#include <QThreadPool>
+#include <atomic>
+
+#include <qgsmapcanvas.h>
+
+#include "tile_loader.h"
+
+/*
+ *  按画布的平移速度和缩放方向预取底图瓦片
+ *  拖动平移时画布只移动已绘制的图像, 结束拖动后才重新绘制; 这里跟踪拖动过程中的鼠标位置,
+ *  推算即将露出的范围和移动速度, 在后台线程池中提前解码沿运动方向的相邻瓦片;
+ *  缩放后按缩放方向预取下一层级中心区域的瓦片
+ *  排队和正在解码的预取瓦片总量受字节预算限制, 新的预测到来时尚未开始的旧任务直接放弃
+ */
+class TilePrefetcher : public QObject {
+    Q_OBJECT
+
+public:
+    TilePrefetcher(QgsMapCanvas *pcanvas, const TileLoader &loader, QObject *parent = nullptr);
+    virtual ~TilePrefetcher() override;
+
+    //排队和正在解码的预取瓦片最多占用的字节数, 跨多次预测累计
+    void set_budget(qint64 bytes) { budget_ = qMax<qint64>(0, bytes); }
+    quint64 prefetched() const { return prefetched_.load(); }
+
+protected:
+    virtual bool eventFilter(QObject *o, QEvent *e) override;
+
+private slots:
+    void on_extent_changed();
+
+private:
+    //以 extent 为当前可见范围, 按速度(米/秒)和缩放方向(1 放大, -1 缩小, 0 不变)预取
+    void prefetch(const QgsRectangle &extent, const QPointF &velocity, int zoom_dir);
+    //距上次更新不足间隔时不更新, 返回 false
+    bool update_velocity(const QPointF &center);
+
+private:
+    QgsMapCanvas *pcanvas_;
+    TileLoader loader_;
+    qint64 budget_;
+
+    // 拖动状态
+    bool dragging_ = false;
+    QPoint drag_origin_;
+    QgsRectangle drag_extent_;
+    QPointF last_center_;
+    qint64 last_ms_ = 0;
+    QPointF velocity_;
+    QElapsedTimer clock_;
+    double last_resolution_ = 0.0;
+
+    QMutex mutex_;
+    QHash<quint64, int> queued_; //已排队尚未完成的瓦片 -> 最近一次需要它的预测序号
+    qint64 inflight_bytes_ = 0;  // queued_ 中瓦片解码后的总字节数
+    std::atomic<int> generation_;
+    std::atomic<quint64> prefetched_;
+    QThreadPool pool_; //最后声明, 析构时先等待任务结束
+};
+
+#endif //__TILE_PREFETCHER_H__
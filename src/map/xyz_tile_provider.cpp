@@ -0,0 +1,113 @@
+#include "xyz_tile_provider.h"
+
+#include <QFileInfo>
+#include <QPainter>
+
+#include <qgsprovidermetadata.h>
+#include <qgsproviderregistry.h>
+#include <qgsrasterblock.h>
+
+#include "raw_tile_cache.h"
+#include "src/io/tile_archive.h"
+#include "src/io/tile_directory.h"
+#include "tile_cache.h"
+
+const QString XyzTileProvider::PROVIDER_KEY = QStringLiteral("xyztiles");
+
+void XyzTileProvider::register_provider() {
+    QgsProviderRegistry *pregistry = QgsProviderRegistry::instance();
+    if (pregistry->providerMetadata(PROVIDER_KEY) != nullptr) return;
+
+    pregistry->registerProvider(new QgsProviderMetadata(
+        PROVIDER_KEY, tr("本地 XYZ 瓦片"), [](const QString &uri, const QgsDataProvider::ProviderOptions &options) {
+            return static_cast<QgsDataProvider *>(new XyzTileProvider(uri, options));
+        }));
+}
+
+XyzTileProvider::XyzTileProvider(const QString &uri, const ProviderOptions &options)
+    : QgsRasterDataProvider(uri, options) {
+    //目录按 {z}/{x}/{y}.png 读取, 文件按瓦片归档读取
+    if (QFileInfo(uri).isDir()) {
+        QSharedPointer<TileDirectory> directory(new TileDirectory);
+        if (directory->open(uri, 256, &error_)) loader_ = TileLoader(uri, directory);
+    } else {
+        QSharedPointer<TileArchive> archive(new TileArchive);
+        if (archive->open(uri, &error_)) loader_ = TileLoader(uri, archive);
+    }
+}
+
+XyzTileProvider::XyzTileProvider(const QString &uri, const ProviderOptions &options, const TileLoader &loader)
+    : QgsRasterDataProvider(uri, options), loader_(loader) {}
+
+QgsRasterInterface *XyzTileProvider::clone() const {
+    XyzTileProvider *provider = new XyzTileProvider(dataSourceUri(), ProviderOptions(), loader_);
+    provider->copyBaseSettings(*this);
+    return provider;
+}
+
+QgsCoordinateReferenceSystem XyzTileProvider::crs() const {
+    return QgsCoordinateReferenceSystem(QStringLiteral("EPSG:3857"));
+}
+
+QgsRectangle XyzTileProvider::extent() const {
+    return QgsRectangle(-TILE_WORLD_HALF, -TILE_WORLD_HALF, TILE_WORLD_HALF, TILE_WORLD_HALF);
+}
+
+QString XyzTileProvider::description() const { return tr("本地 XYZ 瓦片底图"); }
+
+Qgis::DataType XyzTileProvider::dataType(int band) const {
+    Q_UNUSED(band);
+    return Qgis::ARGB32_Premultiplied;
+}
+
+QString XyzTileProvider::htmlMetadata() {
+    if (!loader_.is_valid()) return error_;
+    const TileSource *psource = loader_.source();
+    const TileCache &cache = TileCache::instance();
+    const RawTileCache &raw = RawTileCache::instance();
+    return tr("数据源: %1<br>层级: %2 - %3<br>瓦片边长: %4<br>瓦片缓存: %5 / %6 MB, 命中 %7 次, 未命中 %8 次"
+              "<br>磁盘缓存: 命中 %9 次, 未命中 %10 次, 放弃写入 %11 次")
+        .arg(dataSourceUri())
+        .arg(psource->min_zoom())
+        .arg(psource->max_zoom())
+        .arg(psource->tile_size())
+        .arg(cache.used() / (1024 * 1024))
+        .arg(cache.budget() / (1024 * 1024))
+        .arg(cache.hits())
+        .arg(cache.misses())
+        .arg(raw.hits())
+        .arg(raw.misses())
+        .arg(raw.dropped_stores());
+}
+
+bool XyzTileProvider::readBlock(int band, const QgsRectangle &view_extent, int width, int height, void *data,
+                                QgsRasterBlockFeedback *feedback) {
+    Q_UNUSED(band);
+    if (!loader_.is_valid() || width <= 0 || height <= 0) return false;
+
+    QImage image(static_cast<uchar *>(data), width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    // 1.选择分辨率不低于视图的层级和覆盖视图的瓦片
+    double resolution = view_extent.width() / width;
+    TileRange range = TileLoader::tile_range(view_extent, loader_.zoom_for(resolution));
+    double span = TileLoader::tile_span(range.zoom);
+
+    // 2.逐个取解码后的瓦片并缩放到视图像素位置
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    double size = span / resolution;
+    for (int y = range.first_y; y <= range.last_y; y++) {
+        for (int x = range.first_x; x <= range.last_x; x++) {
+            if (feedback != nullptr && feedback->isCanceled()) return true;
+
+            QImage tile = loader_.image(range.zoom, x, y);
+            if (tile.isNull()) continue;
+
+            double left = (x * span - TILE_WORLD_HALF - view_extent.xMinimum()) / resolution;
+            double top = (view_extent.yMaximum() - (TILE_WORLD_HALF - y * span)) / resolution;
+            painter.drawImage(QRectF(left, top, size, size), tile);
+        }
+    }
+    return true;
+}
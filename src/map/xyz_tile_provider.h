@@ -0,0 +1,60 @@
+#ifndef __XYZ_TILE_PROVIDER_H__
+#define __XYZ_TILE_PROVIDER_H__
+
+#include <qgsrasterdataprovider.h>
+
+#include "tile_loader.h"
+
+/*
+ *  本地 XYZ 瓦片底图的栅格数据源(Web 墨卡托, EPSG:3857), 替代 GDAL_WMS 读取本地瓦片
+ *  数据源地址为瓦片归档文件(tools/tile_packer 生成)或 {z}/{x}/{y}.png 瓦片目录
+ *
+ *  块布局固定: 每级 2^z x 2^z 个 tile_size 边长的瓦片, 左上角为原点, 全球范围 ±20037508.34 米
+ *  绘制时按视图分辨率选择层级, 直接由行列号取瓦片解码后画到输出图像上, 不拼接地址也不走网络
+ *  绘制线程会复制数据源, 副本共用同一个瓦片来源; 瓦片经 TileLoader 读取, 解码结果放入共用的
+ *  TileCache, 开启磁盘缓存时同时写入 RawTileCache, 下次启动不再解码 PNG
+ */
+class XyzTileProvider : public QgsRasterDataProvider {
+    Q_OBJECT
+
+public:
+    static const QString PROVIDER_KEY;
+    //向 QGIS 注册数据源, 在 QgsApplication::initQgis() 之后调用一次
+    static void register_provider();
+
+    explicit XyzTileProvider(const QString &uri, const ProviderOptions &options = ProviderOptions());
+
+    virtual QgsRasterInterface *clone() const override;
+    virtual QgsCoordinateReferenceSystem crs() const override;
+    virtual QgsRectangle extent() const override;
+    virtual bool isValid() const override { return loader_.is_valid(); }
+    virtual QString name() const override { return PROVIDER_KEY; }
+    virtual QString description() const override;
+
+    virtual Qgis::DataType dataType(int band) const override;
+    virtual Qgis::DataType sourceDataType(int band) const override { return dataType(band); }
+    virtual int bandCount() const override { return 1; }
+    virtual int capabilities() const override { return QgsRasterDataProvider::Prefetch; }
+    virtual int xBlockSize() const override { return loader_.is_valid() ? loader_.source()->tile_size() : 0; }
+    virtual int yBlockSize() const override { return xBlockSize(); }
+
+    virtual QString htmlMetadata() override;
+    virtual QString lastErrorTitle() override { return tr("瓦片底图"); }
+    virtual QString lastError() override { return error_; }
+
+    //供预取等在绘制之外读取瓦片
+    const TileLoader &loader() const { return loader_; }
+
+protected:
+    virtual bool readBlock(int band, const QgsRectangle &view_extent, int width, int height, void *data,
+                           QgsRasterBlockFeedback *feedback = nullptr) override;
+
+private:
+    XyzTileProvider(const QString &uri, const ProviderOptions &options, const TileLoader &loader);
+
+private:
+    TileLoader loader_;
+    QString error_;
+};
+
+#endif //__XYZ_TILE_PROVIDER_H__
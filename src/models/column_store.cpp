@@ -0,0 +1,210 @@
+#include "column_store.h"
+
+#include <QtNumeric>
+#include <climits>
+#include <cstring>
+
+#include "element_record.h"
+
+//浮点类型的枚举值转换为代码, NaN 和超出 int 范围的值转为 -1, 避免未定义的转换
+static int enum_code(double value) { return (value >= INT_MIN && value <= INT_MAX) ? static_cast<int>(value) : -1; }
+
+void ColumnStore::set_layout(const ElementDescriptor &desc) {
+    columns_.clear();
+    columns_.resize(desc.field_count);
+    for (int i = 0; i < desc.field_count; i++) {
+        const FieldDescriptor &field = desc.fields[i];
+        if (field.labels != Q_NULLPTR)
+            columns_[i].kind = FIELD_ENUM;
+        else if (field.type == VALUE_INT)
+            columns_[i].kind = FIELD_INT;
+        else if (field.type == VALUE_DOUBLE)
+            columns_[i].kind = FIELD_DOUBLE;
+        else
+            columns_[i].kind = FIELD_STRING;
+    }
+    records_ = 0;
+}
+
+void ColumnStore::clear() {
+    for (auto &col : columns_) {
+        col.ints.clear();
+        col.doubles.clear();
+        col.strings.clear();
+        col.texts.clear();
+    }
+    records_ = 0;
+}
+
+void ColumnStore::reserve(int records) {
+    for (auto &col : columns_) {
+        switch (col.kind) {
+            case FIELD_INT:
+                col.ints.reserve(records);
+                col.texts.reserve(records);
+                break;
+            case FIELD_ENUM:
+                col.ints.reserve(records);
+                break;
+            case FIELD_DOUBLE:
+                col.doubles.reserve(records);
+                col.texts.reserve(records);
+                break;
+            case FIELD_STRING:
+                col.strings.reserve(records);
+                break;
+        }
+    }
+}
+
+int ColumnStore::append_record() {
+    for (auto &col : columns_) {
+        switch (col.kind) {
+            case FIELD_INT:
+                col.ints.append(0);
+                col.texts.append(QString());
+                break;
+            case FIELD_ENUM:
+                col.ints.append(0);
+                break;
+            case FIELD_DOUBLE:
+                col.doubles.append(0.0);
+                col.texts.append(QString());
+                break;
+            case FIELD_STRING:
+                col.strings.append(QString());
+                break;
+        }
+    }
+
+    return records_++;
+}
+
+void ColumnStore::remove_records(int first, int count) {
+    for (auto &col : columns_) {
+        switch (col.kind) {
+            case FIELD_INT:
+                col.ints.remove(first, count);
+                col.texts.remove(first, count);
+                break;
+            case FIELD_ENUM:
+                col.ints.remove(first, count);
+                break;
+            case FIELD_DOUBLE:
+                col.doubles.remove(first, count);
+                col.texts.remove(first, count);
+                break;
+            case FIELD_STRING:
+                col.strings.remove(first, count);
+                break;
+        }
+    }
+    records_ -= count;
+}
+
+quint32 ColumnStore::write(int record, const ElementDescriptor &desc, const void *pdata) {
+    const char *base = static_cast<const char *>(pdata);
+    quint32 changed = 0;
+
+    for (int i = 0; i < desc.field_count; i++) {
+        const FieldDescriptor &field = desc.fields[i];
+        const char *pvalue = base + field.offset;
+        bool diff = false;
+
+        switch (field.type) {
+            case VALUE_INT: {
+                int value = *reinterpret_cast<const int *>(pvalue);
+                diff = (field.labels != Q_NULLPTR) ? set_enum(i, record, value, *field.labels)
+                                                   : set_int(i, record, value);
+                break;
+            }
+            case VALUE_DOUBLE: {
+                double value = *reinterpret_cast<const double *>(pvalue);
+                diff = (field.labels != Q_NULLPTR) ? set_enum(i, record, enum_code(value), *field.labels)
+                                                   : set_double(i, record, value);
+                break;
+            }
+            case VALUE_STRING:
+                diff = set_string(i, record, *reinterpret_cast<const QString *>(pvalue));
+                break;
+        }
+        if (diff) changed |= (1u << i);
+    }
+
+    return changed;
+}
+
+quint32 ColumnStore::write_packed(int record, const ElementDescriptor &desc, const char *payload) {
+    quint32 changed = 0;
+
+    for (int i = 0; i < desc.field_count; i++) {
+        const FieldDescriptor &field = desc.fields[i];
+        bool diff = false;
+
+        //负载不保证对齐, 用 memcpy 取值
+        switch (field.type) {
+            case VALUE_INT: {
+                qint32 value;
+                std::memcpy(&value, payload, sizeof(value));
+                diff = (field.labels != Q_NULLPTR) ? set_enum(i, record, value, *field.labels)
+                                                   : set_int(i, record, value);
+                break;
+            }
+            case VALUE_DOUBLE: {
+                double value;
+                std::memcpy(&value, payload, sizeof(value));
+                diff = (field.labels != Q_NULLPTR) ? set_enum(i, record, enum_code(value), *field.labels)
+                                                   : set_double(i, record, value);
+                break;
+            }
+            case VALUE_STRING:
+                diff = set_string(i, record, QString::fromUtf8(payload, qstrnlen(payload, ELEMENT_STRING_SIZE)));
+                break;
+        }
+        if (diff) changed |= (1u << i);
+        payload += value_packed_size(field.type);
+    }
+
+    return changed;
+}
+
+bool ColumnStore::set_int(int field, int record, int value) {
+    Column &col = columns_[field];
+    int &var = col.ints[record];
+    if (var == value) return false;
+    var = value;
+    if (col.kind == FIELD_INT) col.texts[record].clear();
+    return true;
+}
+
+bool ColumnStore::set_enum(int field, int record, int code, const EnumLabels &labels) {
+    if (static_cast<unsigned>(code) >= static_cast<unsigned>(labels.count)) unknown_codes_++;
+    return set_int(field, record, code);
+}
+
+bool ColumnStore::set_double(int field, int record, double value) {
+    Column &col = columns_[field];
+    double &var = col.doubles[record];
+    //NaN 与自身不相等, 单独判断, 否则持续收到 NaN 时每帧都会通知变化
+    if (var == value || (qIsNaN(var) && qIsNaN(value))) return false;
+    var = value;
+    col.texts[record].clear();
+    return true;
+}
+
+bool ColumnStore::set_string(int field, int record, const QString &value) {
+    QString &var = columns_[field].strings[record];
+    if (var == value) return false;
+    var = value;
+    return true;
+}
+
+const QString &ColumnStore::text_at(int field, int record) const {
+    const Column &col = columns_.at(field);
+    QString &text = col.texts[record];
+    if (text.isNull()) {
+        text = (col.kind == FIELD_INT) ? locale_.toString(col.ints.at(record))
+                                       : locale_.toString(col.doubles.at(record));
+    }
+    return text;
+}
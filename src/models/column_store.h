@@ -0,0 +1,74 @@
+#ifndef __COLUMN_STORE_H__
+#define __COLUMN_STORE_H__
+
+#include <QLocale>
+#include <QString>
+#include <QVector>
+
+#include "element_descriptor.h"
+
+//字段存储类型
+enum FieldKind {
+    FIELD_INT = 0,
+    FIELD_DOUBLE,
+    FIELD_ENUM, //保存枚举下标, 显示时再查文字
+    FIELD_STRING,
+};
+
+/*
+ *  按列存储同一种装备数据的所有记录
+ *  每列只保存一种原始类型, 数据连续存放, 不再为每个单元格构造 QVariant
+ */
+class ColumnStore {
+public:
+    void set_layout(const ElementDescriptor &desc);
+    void clear();
+
+    int field_count() const { return columns_.size(); }
+    int record_count() const { return records_; }
+    FieldKind kind(int field) const { return columns_.at(field).kind; }
+
+    void reserve(int records);
+    int append_record();
+    void remove_records(int first, int count);
+
+    //按描述表把结构体写入一条记录, 返回值变化字段的位掩码
+    quint32 write(int record, const ElementDescriptor &desc, const void *pdata);
+    //同上, 数据来源为 ElementRecord 的紧凑负载
+    quint32 write_packed(int record, const ElementDescriptor &desc, const char *payload);
+
+    //写入字段值, 返回值是否发生变化
+    bool set_int(int field, int record, int value);
+    bool set_double(int field, int record, double value);
+    bool set_string(int field, int record, const QString &value);
+
+    int int_at(int field, int record) const { return columns_.at(field).ints.at(record); }
+    double double_at(int field, int record) const { return columns_.at(field).doubles.at(record); }
+    const QString &string_at(int field, int record) const { return columns_.at(field).strings.at(record); }
+
+    //写入时超出枚举文字表范围的代码次数
+    quint64 unknown_codes() const { return unknown_codes_; }
+
+    //数值字段的显示文字, 首次访问时格式化并缓存, 值变化时失效
+    const QString &text_at(int field, int record) const;
+
+private:
+    bool set_enum(int field, int record, int code, const EnumLabels &labels);
+
+private:
+    struct Column {
+        FieldKind kind;
+        QVector<int> ints;        // FIELD_INT, FIELD_ENUM
+        QVector<double> doubles;  // FIELD_DOUBLE
+        QVector<QString> strings; // FIELD_STRING
+
+        mutable QVector<QString> texts; // FIELD_INT, FIELD_DOUBLE 的显示文字缓存, null 字符串(isNull())表示未格式化, 格式化结果可以是空串
+    };
+
+    QVector<Column> columns_;
+    int records_ = 0;
+    quint64 unknown_codes_ = 0;
+    QLocale locale_; //与视图默认的数值显示方式一致
+};
+
+#endif //__COLUMN_STORE_H__
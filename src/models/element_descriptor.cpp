@@ -0,0 +1,195 @@
+#include "element_descriptor.h"
+
+#define ARRAY_SIZE(a) static_cast<int>(sizeof(a) / sizeof((a)[0]))
+#define FIELD(T, m, type) \
+    { type, offsetof(T, m), Q_NULLPTR }
+#define ENUM_FIELD(T, m, type, labels) \
+    { type, offsetof(T, m), &labels }
+#define LABELS(name, ...)                                \
+    static const char *const name##_text[] = __VA_ARGS__; \
+    static const EnumLabels name = {name##_text, ARRAY_SIZE(name##_text)};
+
+// 1.枚举文字
+LABELS(power_off, {"开机", "待机", "关机"})
+LABELS(control_status, {"本控", "遥控", "其他"})
+LABELS(radiation_state, {"辐射", "静默", "闪烁"})
+LABELS(scanning_mode, {"圆圈顺时针", "圆圈逆时针", "扇扫", "驻留"})
+LABELS(work_state, {"作战", "训练", "试验", "值班"})
+LABELS(equip_statu, {"正常", "降级", "故障"})
+LABELS(combat_permissions, {"允许自主射击", "人工射击"})
+LABELS(command_mode, {"按级", "越级", "接替"})
+LABELS(trace_status, {"手动", "引导", "闭环"})
+LABELS(inter_ception_mode, {"人工", "自动"})
+LABELS(firepower_status, {"无效", "空闲", "占用", "拦截", "已拦"})
+
+// 2.字段描述与表头
+//雷达系统状态
+static const FieldDescriptor system_state_fields[] = {
+    ENUM_FIELD(SystemState, power_off, VALUE_INT, power_off),
+    ENUM_FIELD(SystemState, control_state, VALUE_INT, control_status),
+    ENUM_FIELD(SystemState, scanning_mode, VALUE_INT, scanning_mode),
+    FIELD(SystemState, antenna_eleva_angle, VALUE_DOUBLE),
+    FIELD(SystemState, beam_eleva_angle, VALUE_DOUBLE),
+    FIELD(SystemState, eccm_measures, VALUE_INT),
+    FIELD(SystemState, clutter_map, VALUE_STRING),
+    FIELD(SystemState, emi_intensity, VALUE_DOUBLE),
+    FIELD(SystemState, time_alloca_state, VALUE_DOUBLE),
+    FIELD(SystemState, track_data_rate, VALUE_DOUBLE),
+};
+static const char *const system_state_heads[] = {
+    "开关机:",         "受控状态:",     "天线扫描方式:",     "天线机械俯仰角:", "波束起始扫描仰角:",
+    "抗干扰措施:",     "杂波图:",       "电磁干扰强度:",     "时间资源分配状态:", "跟踪数据率:",
+};
+
+//工作模式
+static const FieldDescriptor work_pattern_fields[] = {
+    FIELD(WorkPattern, id, VALUE_INT),
+    FIELD(WorkPattern, start_yaw, VALUE_DOUBLE),
+    FIELD(WorkPattern, end_yaw, VALUE_DOUBLE),
+};
+static const char *const work_pattern_heads[] = {"编号", "起始方位", "结束方位"};
+
+//辐射状态
+static const FieldDescriptor radiation_state_fields[] = {
+    FIELD(RadiationState, equipment_id, VALUE_INT),
+    ENUM_FIELD(RadiationState, radiation_state, VALUE_INT, radiation_state),
+};
+static const char *const radiation_state_heads[] = {"设备名称", "状态"};
+
+//工作频点
+static const FieldDescriptor work_frequency_fields[] = {
+    FIELD(WorkFrequency, id, VALUE_INT),
+    FIELD(WorkFrequency, frequency_point, VALUE_DOUBLE),
+};
+static const char *const work_frequency_heads[] = {"编号", "频点"};
+
+//有源干扰方向
+static const FieldDescriptor disturb_direction_fields[] = {
+    FIELD(DisturbDirection, id, VALUE_INT),
+    FIELD(DisturbDirection, eleva_angle, VALUE_DOUBLE),
+    FIELD(DisturbDirection, pitch, VALUE_DOUBLE),
+    FIELD(DisturbDirection, power, VALUE_DOUBLE),
+};
+static const char *const disturb_direction_heads[] = {"编号", "俯仰角", "偏航角", "功率"};
+
+//搜索区域
+static const FieldDescriptor region_of_search_fields[] = {
+    FIELD(RegionOfSearch, max_lon, VALUE_DOUBLE),
+    FIELD(RegionOfSearch, min_lon, VALUE_DOUBLE),
+    FIELD(RegionOfSearch, max_lat, VALUE_DOUBLE),
+    FIELD(RegionOfSearch, min_lat, VALUE_DOUBLE),
+};
+static const char *const region_of_search_heads[] = {"最大经度", "最小经度", "最大纬度", "最小纬度"};
+
+//指控系统状态数据描述
+static const FieldDescriptor chain_of_command_fields[] = {
+    ENUM_FIELD(ChainOfCommand, work_state, VALUE_INT, work_state),
+    FIELD(ChainOfCommand, war_preparedness_lv, VALUE_INT),
+    ENUM_FIELD(ChainOfCommand, equip_state, VALUE_INT, equip_statu),
+    ENUM_FIELD(ChainOfCommand, combat_permissions, VALUE_INT, combat_permissions),
+    ENUM_FIELD(ChainOfCommand, command_mode, VALUE_INT, command_mode),
+};
+static const char *const chain_of_command_heads[] = {"系统工作状态:", "战备值班等级:", "装备状态:", "作战权限:",
+                                                     "指挥方式:"};
+
+//光电装备状态显示
+static const FieldDescriptor photoelectricity_fields[] = {
+    FIELD(PhotoelectricityEquipment, id, VALUE_INT),
+    FIELD(PhotoelectricityEquipment, lon, VALUE_DOUBLE),
+    FIELD(PhotoelectricityEquipment, lat, VALUE_DOUBLE),
+    FIELD(PhotoelectricityEquipment, alt, VALUE_DOUBLE),
+    FIELD(PhotoelectricityEquipment, elevation_angle, VALUE_DOUBLE),
+    FIELD(PhotoelectricityEquipment, pitch_angle, VALUE_DOUBLE),
+    ENUM_FIELD(PhotoelectricityEquipment, trace_status, VALUE_INT, trace_status),
+};
+static const char *const photoelectricity_heads[] = {
+    "编号:", "经度:", "维度:", "高度:", "光学中心指向(俯仰角):", "光学中心指向(偏航角):", "搜索跟踪状态:",
+};
+
+//拦截武器显示
+static const FieldDescriptor interceptor_weapon_fields[] = {
+    ENUM_FIELD(DescriptionOfInterceptorWeapon, status, VALUE_DOUBLE, work_state),
+    FIELD(DescriptionOfInterceptorWeapon, war_readiness_lv, VALUE_INT),
+    ENUM_FIELD(DescriptionOfInterceptorWeapon, operational_authority, VALUE_INT, combat_permissions),
+    ENUM_FIELD(DescriptionOfInterceptorWeapon, command_mode, VALUE_INT, command_mode),
+    FIELD(DescriptionOfInterceptorWeapon, app_mode, VALUE_INT),
+    ENUM_FIELD(DescriptionOfInterceptorWeapon, run_status, VALUE_INT, power_off),
+};
+static const char *const interceptor_weapon_heads[] = {
+    "工作状态:",       "战备值班等级:", "作战权限:", "指挥方式:", "传感器应用方式:", "系统运行状态:",
+    "传感器资源占用百分比:",
+};
+
+//拦截弹资源
+static const FieldDescriptor gbi_resources_fields[] = {
+    FIELD(GBIResources, id, VALUE_INT),
+    FIELD(GBIResources, bullet_quantity, VALUE_DOUBLE),
+};
+static const char *const gbi_resources_heads[] = {"发射车id", "可用弹量"};
+
+//制导雷达
+static const FieldDescriptor guidance_radar_fields[] = {
+    FIELD(GuidanceRadar, id, VALUE_INT),
+    FIELD(GuidanceRadar, res_occu_rate, VALUE_DOUBLE),
+};
+static const char *const guidance_radar_heads[] = {"编号", "传感器资源占用百分比"};
+
+//火力单元状态显示
+static const FieldDescriptor firepower_unit_fields[] = {
+    ENUM_FIELD(FirepowerUnit, lon, VALUE_INT, work_state),
+    ENUM_FIELD(FirepowerUnit, command_mode, VALUE_INT, command_mode),
+    FIELD(FirepowerUnit, oper_task, VALUE_INT),
+    ENUM_FIELD(FirepowerUnit, inter_ception_mode, VALUE_INT, inter_ception_mode),
+    FIELD(FirepowerUnit, frequency_point_id, VALUE_INT),
+    FIELD(FirepowerUnit, sector_central_angle, VALUE_DOUBLE),
+};
+static const char *const firepower_unit_heads[] = {"工作方式:", "指挥方式:", "作战任务:",
+                                                   "拦截方式:", "频点号:",   "责任扇区中心角:"};
+
+//火力单元通道状态
+static const FieldDescriptor firepower_aisle_fields[] = {
+    FIELD(FirepowerUnitAisle, unit_id, VALUE_INT),
+    FIELD(FirepowerUnitAisle, target_id, VALUE_INT),
+    ENUM_FIELD(FirepowerUnitAisle, status, VALUE_INT, firepower_status),
+};
+static const char *const firepower_aisle_heads[] = {"火力单元编号", "跟踪目标编号", "状态"};
+
+// 3.按 ElementType 顺序排列的描述表
+#define ELEMENT(TYPE, name, k0, k1) \
+    { TYPE, name##_fields, ARRAY_SIZE(name##_fields), name##_heads, ARRAY_SIZE(name##_heads), {k0, k1} }
+static const ElementDescriptor element_descriptors[] = {
+    ELEMENT(SYSTEM_STATE, system_state, -1, -1),
+    ELEMENT(WORK_PATTERN, work_pattern, 0, -1),
+    ELEMENT(RADIATION_STATE, radiation_state, 0, -1),
+    ELEMENT(WORK_FREQUENCY, work_frequency, 0, -1),
+    ELEMENT(DISTURB_DIRECTION, disturb_direction, 0, -1),
+    ELEMENT(REGION_OF_SEARCH, region_of_search, -1, -1),
+    ELEMENT(CHAIN_OF_COMMAND, chain_of_command, -1, -1),
+    ELEMENT(PHOTOELECTRICITY_EQUIPMENT, photoelectricity, 0, -1),
+    ELEMENT(DESCRIPTION_OF_INTERCEPTOR_WEAPON, interceptor_weapon, -1, -1),
+    ELEMENT(GBI_RESOURCES, gbi_resources, 0, -1),
+    ELEMENT(GUIDANCE_RADAR, guidance_radar, 0, -1),
+    ELEMENT(FIREPOWER_UNIT, firepower_unit, -1, -1),
+    ELEMENT(FIREPOWER_UNIT_AISLE, firepower_aisle, 0, 1),
+};
+static_assert(ARRAY_SIZE(element_descriptors) == ELEMENT_TYPE_COUNT, "element_descriptors out of sync with ElementType");
+
+const ElementDescriptor *element_descriptor(int type) {
+    if (type < 0 || type >= ELEMENT_TYPE_COUNT) return Q_NULLPTR;
+    return &element_descriptors[type];
+}
+
+qint64 element_key(const ElementDescriptor &desc, const void *pdata) {
+    const char *base = static_cast<const char *>(pdata);
+    quint64 key = 0;
+
+    //两个 int 字段拼成 64 位主键
+    for (int i = 0; i < 2; i++) {
+        int field = desc.key_fields[i];
+        if (field < 0) continue;
+        int value = *reinterpret_cast<const int *>(base + desc.fields[field].offset);
+        key = (key << 32) | static_cast<quint32>(value);
+    }
+
+    return static_cast<qint64>(key);
+}
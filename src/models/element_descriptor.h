@@ -0,0 +1,74 @@
+#ifndef __ELEMENT_DESCRIPTOR_H__
+#define __ELEMENT_DESCRIPTOR_H__
+
+#include <cstddef>
+
+#include "elements.h"
+
+/*
+ *  装备数据结构体的静态描述表
+ *  字段偏移、类型、枚举文字和表头在编译期确定, 新增装备类型时只需在
+ *  element_descriptor.cpp 中补充一张表并声明 ElementTraits, 无需修改模型代码
+ */
+
+//结构体字段的原始类型
+enum ValueType {
+    VALUE_INT = 0,
+    VALUE_DOUBLE,
+    VALUE_STRING, // QString
+};
+
+//枚举文字表
+struct EnumLabels {
+    const char *const *labels;
+    int count;
+};
+
+//单个字段描述
+struct FieldDescriptor {
+    ValueType type;
+    size_t offset;
+    const EnumLabels *labels; //非空时按枚举文字显示
+};
+
+//单个结构体描述
+struct ElementDescriptor {
+    ElementType type;
+    const FieldDescriptor *fields;
+    int field_count;
+    const char *const *head_names;
+    int head_count;
+    int key_fields[2]; //组成主键的 int 字段下标, -1 表示不使用; 都为 -1 时只有一条记录
+};
+
+//按类型取描述表, 类型无效时返回空
+const ElementDescriptor *element_descriptor(int type);
+
+//按描述表从结构体中取主键
+qint64 element_key(const ElementDescriptor &desc, const void *pdata);
+
+//结构体类型与 ElementType 的对应关系
+template <typename T>
+struct ElementTraits;
+
+#define DECLARE_ELEMENT_TRAITS(T, TYPE)       \
+    template <>                               \
+    struct ElementTraits<T> {                 \
+        static const ElementType type = TYPE; \
+    };
+
+DECLARE_ELEMENT_TRAITS(SystemState, SYSTEM_STATE)
+DECLARE_ELEMENT_TRAITS(WorkPattern, WORK_PATTERN)
+DECLARE_ELEMENT_TRAITS(RadiationState, RADIATION_STATE)
+DECLARE_ELEMENT_TRAITS(WorkFrequency, WORK_FREQUENCY)
+DECLARE_ELEMENT_TRAITS(DisturbDirection, DISTURB_DIRECTION)
+DECLARE_ELEMENT_TRAITS(RegionOfSearch, REGION_OF_SEARCH)
+DECLARE_ELEMENT_TRAITS(ChainOfCommand, CHAIN_OF_COMMAND)
+DECLARE_ELEMENT_TRAITS(PhotoelectricityEquipment, PHOTOELECTRICITY_EQUIPMENT)
+DECLARE_ELEMENT_TRAITS(DescriptionOfInterceptorWeapon, DESCRIPTION_OF_INTERCEPTOR_WEAPON)
+DECLARE_ELEMENT_TRAITS(GBIResources, GBI_RESOURCES)
+DECLARE_ELEMENT_TRAITS(GuidanceRadar, GUIDANCE_RADAR)
+DECLARE_ELEMENT_TRAITS(FirepowerUnit, FIREPOWER_UNIT)
+DECLARE_ELEMENT_TRAITS(FirepowerUnitAisle, FIREPOWER_UNIT_AISLE)
+
+#endif //__ELEMENT_DESCRIPTOR_H__
@@ -0,0 +1,67 @@
+#include "element_record.h"
+
+#include <cstring>
+
+int value_packed_size(ValueType type) {
+    switch (type) {
+        case VALUE_INT:
+            return sizeof(qint32);
+        case VALUE_DOUBLE:
+            return sizeof(double);
+        case VALUE_STRING:
+            return ELEMENT_STRING_SIZE;
+    }
+    return 0;
+}
+
+int element_packed_size(const ElementDescriptor &desc) {
+    int size = 0;
+    for (int i = 0; i < desc.field_count; i++) {
+        size += value_packed_size(desc.fields[i].type);
+    }
+    return size;
+}
+
+void pack_element(const ElementDescriptor &desc, const void *pdata, ElementRecord *precord) {
+    const char *base = static_cast<const char *>(pdata);
+    char *out = precord->payload;
+
+    for (int i = 0; i < desc.field_count; i++) {
+        const FieldDescriptor &field = desc.fields[i];
+        int size = value_packed_size(field.type);
+
+        if (field.type == VALUE_STRING) {
+            //超长时截断, 保留结尾的 0
+            QByteArray utf8 = reinterpret_cast<const QString *>(base + field.offset)->toUtf8();
+            std::memset(out, 0, size);
+            std::memcpy(out, utf8.constData(), qMin(utf8.size(), size - 1));
+        } else {
+            std::memcpy(out, base + field.offset, size);
+        }
+        out += size;
+    }
+
+    precord->type = desc.type;
+    precord->key = element_key(desc, pdata);
+    precord->flags = 0;
+}
+
+qint64 packed_key(const ElementDescriptor &desc, const char *payload) {
+    //先算出主键字段的紧凑偏移
+    int offsets[2] = {-1, -1};
+    int offset = 0;
+    for (int i = 0; i < desc.field_count; i++) {
+        if (i == desc.key_fields[0]) offsets[0] = offset;
+        if (i == desc.key_fields[1]) offsets[1] = offset;
+        offset += value_packed_size(desc.fields[i].type);
+    }
+
+    quint64 key = 0;
+    for (int i = 0; i < 2; i++) {
+        if (offsets[i] < 0) continue;
+        qint32 value;
+        std::memcpy(&value, payload + offsets[i], sizeof(value));
+        key = (key << 32) | static_cast<quint32>(value);
+    }
+    return static_cast<qint64>(key);
+}
@@ -0,0 +1,41 @@
+#ifndef __ELEMENT_RECORD_H__
+#define __ELEMENT_RECORD_H__
+
+#include <QMetaType>
+#include <QVector>
+
+#include "element_descriptor.h"
+
+//字符串字段在紧凑格式中的固定长度(UTF-8, 不足补 0)
+const int ELEMENT_STRING_SIZE = 32;
+//紧凑格式负载的最大长度, 需容纳最大的结构体
+const int ELEMENT_PAYLOAD_SIZE = 104;
+//删除该主键的记录, 负载中只有主键字段有效
+const qint32 RECORD_REMOVED = 0x1;
+
+/*
+ *  解码后的定长记录
+ *  payload 按描述表字段顺序紧凑排列(int32 / double / 定长字符串), 主机字节序,
+ *  与具体结构体解耦, 便于在线程间、队列和记录文件中按值传递
+ */
+struct ElementRecord {
+    qint64 timestamp; //单调时钟, 毫秒
+    qint64 key;       //主键, 见 element_key()
+    qint32 type;      // ElementType
+    qint32 flags;     // RECORD_REMOVED
+    char payload[ELEMENT_PAYLOAD_SIZE];
+};
+Q_DECLARE_METATYPE(ElementRecord);
+Q_DECLARE_METATYPE(QVector<ElementRecord>);
+
+//字段在紧凑格式中占用的字节数
+int value_packed_size(ValueType type);
+//结构体在紧凑格式中占用的字节数
+int element_packed_size(const ElementDescriptor &desc);
+
+//结构体 -> 紧凑记录
+void pack_element(const ElementDescriptor &desc, const void *pdata, ElementRecord *precord);
+//按描述表从紧凑负载中取主键
+qint64 packed_key(const ElementDescriptor &desc, const char *payload);
+
+#endif //__ELEMENT_RECORD_H__
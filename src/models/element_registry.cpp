@@ -0,0 +1,53 @@
+#include "element_registry.h"
+
+#include "element_record.h"
+
+const ElementRegistry &ElementRegistry::instance() {
+    //局部静态变量的初始化是线程安全的
+    static const ElementRegistry registry;
+    return registry;
+}
+
+ElementRegistry::ElementRegistry() : unknown_label_(QString::fromUtf8("未知")) {
+    headnames_.resize(ELEMENT_TYPE_COUNT);
+
+    for (int type = 0; type < ELEMENT_TYPE_COUNT; type++) {
+        const ElementDescriptor *pdesc = element_descriptor(type);
+        Q_ASSERT(element_packed_size(*pdesc) <= ELEMENT_PAYLOAD_SIZE);
+
+        // 1.表头
+        QStringList &heads = headnames_[type];
+        for (int i = 0; i < pdesc->head_count; i++) {
+            heads << QString::fromUtf8(pdesc->head_names[i]);
+        }
+
+        // 2.枚举文字, 多个字段共用同一张表时只转换一次
+        for (int i = 0; i < pdesc->field_count; i++) {
+            const EnumLabels *plabels = pdesc->fields[i].labels;
+            if (plabels == Q_NULLPTR || map_labels_.contains(plabels)) continue;
+
+            QVector<QString> &texts = map_labels_[plabels];
+            texts.reserve(plabels->count);
+            for (int j = 0; j < plabels->count; j++) {
+                texts.append(QString::fromUtf8(plabels->labels[j]));
+            }
+        }
+    }
+}
+
+const QStringList *ElementRegistry::head_names(int type) const {
+    if (type < 0 || type >= headnames_.size()) return Q_NULLPTR;
+    return &headnames_.at(type);
+}
+
+LabelTable ElementRegistry::labels(const EnumLabels *labels) const {
+    LabelTable table = {Q_NULLPTR, 0};
+    if (labels == Q_NULLPTR) return table;
+
+    auto var = map_labels_.constFind(labels);
+    if (var != map_labels_.constEnd()) {
+        table.texts = var.value().constData();
+        table.count = var.value().size();
+    }
+    return table;
+}
@@ -0,0 +1,45 @@
+#ifndef __ELEMENT_REGISTRY_H__
+#define __ELEMENT_REGISTRY_H__
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include "element_descriptor.h"
+
+//枚举文字表, 按代码直接下标访问
+struct LabelTable {
+    const QString *texts;
+    int count;
+
+    //超出范围返回空指针, 负数转为无符号后同样超出范围
+    const QString *find(int code) const {
+        return (static_cast<unsigned>(code) < static_cast<unsigned>(count)) ? texts + code : Q_NULLPTR;
+    }
+};
+
+/*
+ *  全局只读的表头文字和枚举文字表
+ *  由 element_descriptor.cpp 中的静态描述表转换而来, 进程内只构造一次,
+ *  所有 TableModel 共享同一份数据
+ */
+class ElementRegistry {
+public:
+    static const ElementRegistry &instance();
+
+    const QStringList *head_names(int type) const;
+    LabelTable labels(const EnumLabels *labels) const;
+    //未知枚举代码的显示文字
+    const QString &unknown_label() const { return unknown_label_; }
+
+private:
+    ElementRegistry();
+    Q_DISABLE_COPY(ElementRegistry)
+
+private:
+    QVector<QStringList> headnames_; //按 ElementType 下标
+    QHash<const EnumLabels *, QVector<QString>> map_labels_; //构造后不再修改, 数据地址保持不变
+    QString unknown_label_;
+};
+
+#endif //__ELEMENT_REGISTRY_H__
@@ -140,6 +140,7 @@ enum ElementType {
     GUIDANCE_RADAR,
     FIREPOWER_UNIT,
     FIREPOWER_UNIT_AISLE,
+    ELEMENT_TYPE_COUNT, //类型数量
 };
 Q_DECLARE_METATYPE(ElementType);
 
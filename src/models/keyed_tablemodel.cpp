@@ -0,0 +1,236 @@
+#include "keyed_tablemodel.h"
+
+#include <algorithm>
+
+KeyedTableModel::KeyedTableModel(QObject *parent) : TableModel(parent) {}
+
+int KeyedTableModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return row_keys_.size() - gap_size_;
+}
+
+QVariant KeyedTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    return cell_data(index.column(), row_slots_.at(row_index(index.row())), role);
+}
+
+void KeyedTableModel::init_layout(const ElementDescriptor &desc) {
+    TableModel::init_layout(desc);
+    local_ = HORIZONTAL_HEAD;
+
+    row_keys_.clear();
+    row_slots_.clear();
+    gap_ = 0;
+    gap_size_ = 0;
+    map_key_slots_.clear();
+    slot_keys_.clear();
+    slot_states_.clear();
+    slot_fields_.clear();
+    free_slots_.clear();
+    dirty_slots_.clear();
+    new_slots_.clear();
+    removed_slots_.clear();
+}
+
+int KeyedTableModel::find_or_append(qint64 key) {
+    int slot = map_key_slots_.value(key, -1);
+    if (slot >= 0) return slot;
+
+    //优先复用已删除记录的槽位
+    if (!free_slots_.isEmpty()) {
+        slot = free_slots_.takeLast();
+    } else {
+        slot = store_.append_record();
+        slot_keys_.append(0);
+        slot_states_.append(SLOT_FREE);
+        slot_fields_.append(0);
+    }
+
+    slot_keys_[slot] = key;
+    slot_states_[slot] = SLOT_NEW;
+    map_key_slots_.insert(key, slot);
+    new_slots_.insert(slot);
+    return slot;
+}
+
+void KeyedTableModel::mark_dirty(int slot, quint32 fields) {
+    //新记录随插入一并通知
+    fields &= ~(hidden_fields_ & ~watched_fields_);
+    if (parked_ || fields == 0 || slot_states_.at(slot) != SLOT_SHOWN) return;
+
+    if (slot_fields_.at(slot) == 0) dirty_slots_.append(slot);
+    slot_fields_[slot] |= fields;
+}
+
+void KeyedTableModel::remove_key(qint64 key) {
+    auto var = map_key_slots_.find(key);
+    if (var == map_key_slots_.end()) return;
+
+    int slot = var.value();
+    map_key_slots_.erase(var);
+
+    //尚未显示的记录直接回收
+    if (slot_states_.at(slot) == SLOT_NEW) {
+        new_slots_.remove(slot);
+        free_slot(slot);
+        return;
+    }
+    slot_states_[slot] = SLOT_REMOVED;
+    removed_slots_.append(slot);
+}
+
+void KeyedTableModel::free_slot(int slot) {
+    slot_states_[slot] = SLOT_FREE;
+    slot_fields_[slot] = 0;
+    free_slots_.append(slot);
+}
+
+int KeyedTableModel::row_of(qint64 key) const {
+    auto it = std::lower_bound(row_keys_.constBegin(), row_keys_.constEnd(), order_key(key));
+    return static_cast<int>(it - row_keys_.constBegin());
+}
+
+void KeyedTableModel::update() {
+    if (parked_) return;
+
+    // 1.删除
+    apply_removals(true);
+
+    // 2.更新: 按行号排序, 相邻且变化字段相同的行合并为一个区域
+    if (!dirty_slots_.isEmpty()) {
+        QVector<int> rows;
+        rows.reserve(dirty_slots_.size());
+        for (int slot : dirty_slots_) {
+            //本批次已删除的记录不再通知
+            if (slot_states_.at(slot) == SLOT_SHOWN) rows.append(row_of(slot_keys_.at(slot)));
+        }
+        std::sort(rows.begin(), rows.end());
+
+        int i = 0;
+        while (i < rows.size()) {
+            int first = rows.at(i);
+            quint32 fields = slot_fields_.at(row_slots_.at(first));
+            int last = first;
+            while (i + 1 < rows.size() && rows.at(i + 1) == last + 1 &&
+                   slot_fields_.at(row_slots_.at(last + 1)) == fields) {
+                last = rows.at(++i);
+            }
+            i++;
+
+            emit_changed(first, last, fields);
+        }
+        for (int slot : dirty_slots_) slot_fields_[slot] = 0;
+        dirty_slots_.clear();
+    }
+
+    // 3.插入
+    apply_inserts(true);
+}
+
+void KeyedTableModel::apply_removals(bool notify) {
+    if (removed_slots_.isEmpty()) return;
+
+    QVector<int> rows;
+    rows.reserve(removed_slots_.size());
+    for (int slot : removed_slots_) {
+        rows.append(row_of(slot_keys_.at(slot)));
+        free_slot(slot);
+    }
+    removed_slots_.clear();
+    std::sort(rows.begin(), rows.end());
+
+    //从前往后按连续区间删除, 保留的行向前归并; [write, read) 为已删除的空洞, read 之后尚未移动
+    int write = 0;
+    int read = 0;
+    int removed = 0;
+    int i = 0;
+    while (i < rows.size()) {
+        int first = rows.at(i);
+        int last = first;
+        while (i + 1 < rows.size() && rows.at(i + 1) == last + 1) last = rows.at(++i);
+        i++;
+
+        if (notify) this->beginRemoveRows(QModelIndex(), first - removed, last - removed);
+        std::copy(row_keys_.constBegin() + read, row_keys_.constBegin() + first, row_keys_.begin() + write);
+        std::copy(row_slots_.constBegin() + read, row_slots_.constBegin() + first, row_slots_.begin() + write);
+        write += first - read;
+        read = last + 1;
+        removed += last - first + 1;
+        gap_ = write;
+        gap_size_ = read - write;
+        if (notify) this->endRemoveRows();
+    }
+
+    std::copy(row_keys_.constBegin() + read, row_keys_.constEnd(), row_keys_.begin() + write);
+    std::copy(row_slots_.constBegin() + read, row_slots_.constEnd(), row_slots_.begin() + write);
+    row_keys_.resize(row_keys_.size() - removed);
+    row_slots_.resize(row_slots_.size() - removed);
+    gap_ = 0;
+    gap_size_ = 0;
+}
+
+void KeyedTableModel::apply_inserts(bool notify) {
+    if (new_slots_.isEmpty()) return;
+
+    QVector<int> inserts;
+    inserts.reserve(new_slots_.size());
+    for (int slot : new_slots_) inserts.append(slot);
+    new_slots_.clear();
+    std::sort(inserts.begin(), inserts.end(),
+              [=](int a, int b) { return order_key(slot_keys_.at(a)) < order_key(slot_keys_.at(b)); });
+
+    //每条新记录在原有行中的插入位置, 新主键有序, 位置不减
+    int count = inserts.size();
+    QVector<int> rows(count);
+    auto from = row_keys_.constBegin();
+    for (int i = 0; i < count; i++) {
+        from = std::lower_bound(from, row_keys_.constEnd(), order_key(slot_keys_.at(inserts.at(i))));
+        rows[i] = static_cast<int>(from - row_keys_.constBegin());
+    }
+
+    //一次扩容, 从后往前归并, 落在同一位置的连续新主键一次插入; 未归并的新行留在原有行之后作为空洞
+    int read = row_keys_.size();
+    row_keys_.resize(read + count);
+    row_slots_.resize(read + count);
+    gap_ = read;
+    gap_size_ = count;
+
+    int i = count;
+    while (i > 0) {
+        int row = rows.at(i - 1);
+        int end = i;
+        while (i > 0 && rows.at(i - 1) == row) i--;
+        int n = end - i;
+
+        if (notify) this->beginInsertRows(QModelIndex(), row, row + n - 1);
+        std::copy_backward(row_keys_.constBegin() + row, row_keys_.constBegin() + read,
+                           row_keys_.begin() + read + gap_size_);
+        std::copy_backward(row_slots_.constBegin() + row, row_slots_.constBegin() + read,
+                           row_slots_.begin() + read + gap_size_);
+        gap_size_ -= n;
+        for (int j = 0; j < n; j++) {
+            int slot = inserts.at(i + j);
+            row_keys_[row + gap_size_ + j] = order_key(slot_keys_.at(slot));
+            row_slots_[row + gap_size_ + j] = slot;
+            slot_states_[slot] = SLOT_SHOWN;
+        }
+        gap_ = row;
+        read = row;
+        if (notify) this->endInsertRows();
+    }
+    gap_ = 0;
+}
+
+void KeyedTableModel::set_parked(bool parked) {
+    if (parked_ == parked) return;
+    parked_ = parked;
+    if (parked_) return;
+
+    //停放期间的变化没有逐条记录, 整体重置一次视图
+    this->beginResetModel();
+    apply_removals(false);
+    apply_inserts(false);
+    for (int slot : dirty_slots_) slot_fields_[slot] = 0;
+    dirty_slots_.clear();
+    this->endResetModel();
+}
@@ -0,0 +1,66 @@
+#ifndef __KEYED_TABLEMODEL_H__
+#define __KEYED_TABLEMODEL_H__
+
+#include <QSet>
+
+#include "tablemodel.h"
+
+/*
+ *  大量按主键组织的记录(如火力单元通道, 上万行), 只支持水平表头
+ *  行按主键字段的有符号值升序排列, 行号只随插入删除整体移动; 存储槽位固定不动, 删除后的槽位放入空闲表复用
+ *  插入、删除、更新都按行区间增量通知, 不重置模型, 不重建索引
+ *  一个批次的插入(删除)只归并一遍行数组, 各区间通知之间未归并的部分作为空洞跳过
+ */
+class KeyedTableModel : public TableModel {
+public:
+    KeyedTableModel(QObject *parent = Q_NULLPTR);
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual void remove_key(qint64 key) override;
+
+    virtual void update() override;
+    virtual bool has_pending() const override {
+        return !parked_ && (!dirty_slots_.isEmpty() || !new_slots_.isEmpty() || !removed_slots_.isEmpty());
+    }
+    virtual void set_parked(bool parked) override;
+
+protected:
+    virtual QVariant data(const QModelIndex &index, int role) const override;
+
+    virtual void init_layout(const ElementDescriptor &desc) override;
+    virtual int find_or_append(qint64 key) override;
+    virtual void mark_dirty(int slot, quint32 fields) override;
+
+private:
+    //主键的两个 32 位字段各自翻转符号位, 按无符号比较即为按字段有符号值的字典序
+    static quint64 order_key(qint64 key) { return static_cast<quint64>(key) ^ 0x8000000080000000ull; }
+    int row_of(qint64 key) const;
+    //行号 -> 行数组下标, 归并过程中跳过空洞
+    int row_index(int row) const { return (row < gap_) ? row : row + gap_size_; }
+    void free_slot(int slot);
+    void apply_removals(bool notify);
+    void apply_inserts(bool notify);
+
+private:
+    enum SlotState : quint8 { SLOT_FREE = 0, SLOT_NEW, SLOT_SHOWN, SLOT_REMOVED };
+
+    //按行顺序, order_key 升序; 只在归并过程中存在 [gap_, gap_ + gap_size_) 的空洞
+    QVector<quint64> row_keys_;
+    QVector<int> row_slots_;
+    int gap_ = 0;
+    int gap_size_ = 0;
+
+    //按存储槽位
+    QHash<qint64, int> map_key_slots_;
+    QVector<qint64> slot_keys_;
+    QVector<quint8> slot_states_;
+    QVector<quint32> slot_fields_; //已显示记录的变化字段
+    QVector<int> free_slots_;
+
+    //本批次变化
+    QVector<int> dirty_slots_;
+    QSet<int> new_slots_; //删除未显示的记录时按槽位移除
+    QVector<int> removed_slots_;
+};
+
+#endif //__KEYED_TABLEMODEL_H__
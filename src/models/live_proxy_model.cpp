@@ -0,0 +1,296 @@
+#include "live_proxy_model.h"
+
+#include <QtNumeric>
+#include <algorithm>
+
+#include "tablemodel.h"
+
+LiveProxyModel::LiveProxyModel(QObject *parent) : QAbstractProxyModel(parent) {}
+
+void LiveProxyModel::setSourceModel(QAbstractItemModel *source) {
+    this->beginResetModel();
+    if (sourceModel() != Q_NULLPTR) {
+        disconnect(sourceModel(), Q_NULLPTR, this, Q_NULLPTR);
+        TableModel *pmodel = dynamic_cast<TableModel *>(sourceModel());
+        if (pmodel != Q_NULLPTR) pmodel->set_watched_fields(0);
+    }
+
+    QAbstractProxyModel::setSourceModel(source);
+    if (source != Q_NULLPTR) {
+        connect(source, &QAbstractItemModel::dataChanged, this, &LiveProxyModel::on_data_changed);
+        connect(source, &QAbstractItemModel::rowsInserted, this, &LiveProxyModel::on_rows_inserted);
+        connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this, &LiveProxyModel::on_rows_about_to_be_removed);
+        connect(source, &QAbstractItemModel::rowsRemoved, this, &LiveProxyModel::on_rows_removed);
+
+        //结构性变化很少发生, 整体重建
+        connect(source, &QAbstractItemModel::modelAboutToBeReset, this, &LiveProxyModel::beginResetModel);
+        connect(source, &QAbstractItemModel::modelReset, this, [=] {
+            rebuild();
+            this->endResetModel();
+        });
+        connect(source, &QAbstractItemModel::layoutAboutToBeChanged, this, &LiveProxyModel::beginResetModel);
+        connect(source, &QAbstractItemModel::layoutChanged, this, [=] {
+            rebuild();
+            this->endResetModel();
+        });
+        connect(source, &QAbstractItemModel::columnsAboutToBeInserted, this, &LiveProxyModel::beginResetModel);
+        connect(source, &QAbstractItemModel::columnsInserted, this, [=] {
+            rebuild();
+            this->endResetModel();
+        });
+        connect(source, &QAbstractItemModel::columnsAboutToBeRemoved, this, &LiveProxyModel::beginResetModel);
+        connect(source, &QAbstractItemModel::columnsRemoved, this, [=] {
+            rebuild();
+            this->endResetModel();
+        });
+    }
+    watch_key_fields();
+    rebuild();
+    this->endResetModel();
+}
+
+void LiveProxyModel::sort(int column, Qt::SortOrder order) {
+    //用户操作, 整体重排一次
+    this->beginResetModel();
+    sort_column_ = column;
+    sort_order_ = order;
+    watch_key_fields();
+    rebuild();
+    this->endResetModel();
+}
+
+void LiveProxyModel::set_filter(int column, const QStringList &texts) {
+    this->beginResetModel();
+    filter_column_ = texts.isEmpty() ? -1 : column;
+    filter_texts_.clear();
+    for (const QString &text : texts) filter_texts_.insert(text);
+    watch_key_fields();
+    rebuild();
+    this->endResetModel();
+}
+
+void LiveProxyModel::rebuild() {
+    keys_.clear();
+    accepted_.clear();
+    rows_.clear();
+
+    QAbstractItemModel *source = sourceModel();
+    if (source == Q_NULLPTR) return;
+
+    int count = source->rowCount();
+    keys_.resize(count);
+    accepted_.resize(count);
+    rows_.reserve(count);
+    for (int row = 0; row < count; row++) {
+        refresh_key(row);
+        if (accepted_.at(row)) rows_.append(row);
+    }
+    std::sort(rows_.begin(), rows_.end(), [=](int a, int b) { return less(a, b); });
+}
+
+void LiveProxyModel::watch_key_fields() {
+    //隐藏字段默认不通知, 排序列或过滤列被隐藏时行位置会停留在旧值上
+    TableModel *pmodel = dynamic_cast<TableModel *>(sourceModel());
+    if (pmodel == Q_NULLPTR) return;
+
+    quint32 fields = 0;
+    if (sort_column_ >= 0 && sort_column_ < 32) fields |= 1u << sort_column_;
+    if (filter_column_ >= 0 && filter_column_ < 32) fields |= 1u << filter_column_;
+    pmodel->set_watched_fields(fields);
+}
+
+void LiveProxyModel::refresh_key(int source_row) {
+    QAbstractItemModel *source = sourceModel();
+
+    SortKey &key = keys_[source_row];
+    if (sort_column_ >= 0) {
+        QVariant value = source->index(source_row, sort_column_).data(RAW_VALUE_ROLE);
+        bool numeric = (value.type() == QVariant::Int || value.type() == QVariant::Double);
+        key.number = numeric ? value.toDouble() : 0.0;
+        key.rank = !numeric ? RANK_TEXT : (qIsNaN(key.number) ? RANK_NAN : RANK_NUMBER);
+        key.text = numeric ? QString() : value.toString();
+    }
+
+    accepted_[source_row] = accepts(source_row);
+}
+
+bool LiveProxyModel::accepts(int source_row) const {
+    if (filter_column_ < 0) return true;
+    //过滤列可能被隐藏, 隐藏字段的 DisplayRole 为空, 取不受隐藏影响的显示文字
+    QString text = sourceModel()->index(source_row, filter_column_).data(LABEL_TEXT_ROLE).toString();
+    return filter_texts_.contains(text);
+}
+
+bool LiveProxyModel::less(int a, int b) const {
+    if (sort_column_ >= 0) {
+        const SortKey &ka = keys_.at(a);
+        const SortKey &kb = keys_.at(b);
+        int cmp = 0;
+        if (ka.rank != kb.rank)
+            cmp = (ka.rank < kb.rank) ? -1 : 1; //数值、NaN、文字依次排列
+        else if (ka.rank == RANK_NUMBER)
+            cmp = (ka.number < kb.number) ? -1 : (kb.number < ka.number ? 1 : 0);
+        else if (ka.rank == RANK_TEXT)
+            cmp = ka.text.compare(kb.text);
+
+        if (cmp != 0) return (sort_order_ == Qt::AscendingOrder) ? (cmp < 0) : (cmp > 0);
+    }
+    return a < b;
+}
+
+int LiveProxyModel::lower_bound(int first, int last, int source_row) const {
+    //在 rows_[first, last) 中查找第一个不小于 source_row 的位置
+    while (first < last) {
+        int mid = first + (last - first) / 2;
+        if (less(rows_.at(mid), source_row))
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return first;
+}
+
+int LiveProxyModel::position(int source_row) const {
+    //排序键为全序, 按当前键二分即可找到该行
+    return lower_bound(0, rows_.size(), source_row);
+}
+
+void LiveProxyModel::on_data_changed(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+    int first_col = top_left.column(), last_col = bottom_right.column();
+    bool key_changed = (sort_column_ >= first_col && sort_column_ <= last_col) ||
+                       (filter_column_ >= first_col && filter_column_ <= last_col);
+
+    for (int row = top_left.row(); row <= bottom_right.row(); row++) {
+        bool was_accepted = accepted_.at(row);
+        int from = was_accepted ? position(row) : -1;
+
+        if (key_changed) refresh_key(row);
+        bool now_accepted = accepted_.at(row);
+
+        // 1.被过滤掉
+        if (was_accepted && !now_accepted) {
+            this->beginRemoveRows(QModelIndex(), from, from);
+            rows_.remove(from);
+            this->endRemoveRows();
+            continue;
+        }
+
+        // 2.新通过过滤
+        if (!was_accepted && now_accepted) {
+            int to = position(row);
+            this->beginInsertRows(QModelIndex(), to, to);
+            rows_.insert(to, row);
+            this->endInsertRows();
+            continue;
+        }
+        if (!now_accepted) continue;
+
+        // 3.排序键变化, 只在越过前后相邻行时移动
+        if (key_changed) {
+            int to = from;
+            if (from > 0 && less(row, rows_.at(from - 1)))
+                to = lower_bound(0, from, row);
+            else if (from + 1 < rows_.size() && less(rows_.at(from + 1), row))
+                to = lower_bound(from + 1, rows_.size(), row);
+
+            if (to != from) {
+                //目标位置按移动前的下标计算, 向后移动时为插入点之后
+                this->beginMoveRows(QModelIndex(), from, from, QModelIndex(), to);
+                rows_.remove(from);
+                rows_.insert(to > from ? to - 1 : to, row);
+                this->endMoveRows();
+                from = (to > from) ? to - 1 : to;
+            }
+        }
+
+        emit dataChanged(this->index(from, first_col), this->index(from, last_col));
+    }
+}
+
+void LiveProxyModel::on_rows_inserted(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) return;
+    int count = last - first + 1;
+
+    //其后的源行号整体后移, 相对顺序不变; 末尾追加时没有需要平移的行
+    if (first < keys_.size()) {
+        for (int &row : rows_) {
+            if (row >= first) row += count;
+        }
+    }
+    keys_.insert(first, count, SortKey());
+    accepted_.insert(first, count, false);
+
+    for (int row = first; row <= last; row++) {
+        refresh_key(row);
+        if (!accepted_.at(row)) continue;
+
+        int to = position(row);
+        this->beginInsertRows(QModelIndex(), to, to);
+        rows_.insert(to, row);
+        this->endInsertRows();
+    }
+}
+
+void LiveProxyModel::on_rows_about_to_be_removed(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) return;
+
+    for (int row = first; row <= last; row++) {
+        if (!accepted_.at(row)) continue;
+
+        int from = position(row);
+        this->beginRemoveRows(QModelIndex(), from, from);
+        rows_.remove(from);
+        this->endRemoveRows();
+    }
+}
+
+void LiveProxyModel::on_rows_removed(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) return;
+    int count = last - first + 1;
+
+    keys_.remove(first, count);
+    accepted_.remove(first, count);
+    for (int &row : rows_) {
+        if (row > last) row -= count;
+    }
+}
+
+QModelIndex LiveProxyModel::index(int row, int column, const QModelIndex &parent) const {
+    if (parent.isValid() || row < 0 || row >= rows_.size() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex LiveProxyModel::parent(const QModelIndex &child) const {
+    Q_UNUSED(child)
+    return QModelIndex();
+}
+
+int LiveProxyModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return rows_.size();
+}
+
+int LiveProxyModel::columnCount(const QModelIndex &parent) const {
+    if (parent.isValid() || sourceModel() == Q_NULLPTR) return 0;
+    return sourceModel()->columnCount();
+}
+
+QVariant LiveProxyModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (sourceModel() == Q_NULLPTR) return QVariant();
+    if (orientation == Qt::Horizontal) return sourceModel()->headerData(section, orientation, role);
+    if (section < 0 || section >= rows_.size()) return QVariant();
+    return sourceModel()->headerData(rows_.at(section), orientation, role);
+}
+
+QModelIndex LiveProxyModel::mapToSource(const QModelIndex &proxy_index) const {
+    if (!proxy_index.isValid() || sourceModel() == Q_NULLPTR || proxy_index.row() >= rows_.size())
+        return QModelIndex();
+    return sourceModel()->index(rows_.at(proxy_index.row()), proxy_index.column());
+}
+
+QModelIndex LiveProxyModel::mapFromSource(const QModelIndex &source_index) const {
+    if (!source_index.isValid() || source_index.row() >= accepted_.size() || !accepted_.at(source_index.row()))
+        return QModelIndex();
+    return this->index(position(source_index.row()), source_index.column());
+}
@@ -0,0 +1,72 @@
+#ifndef __LIVE_PROXY_MODEL_H__
+#define __LIVE_PROXY_MODEL_H__
+
+#include <QAbstractProxyModel>
+#include <QSet>
+#include <QVector>
+
+/*
+ *  实时表格的排序与过滤, 源模型为水平表头的 TableModel(每行一条记录)
+ *  每行缓存排序键和过滤结果, 行顺序保存在有序数组中, 位置用二分查找确定;
+ *  源数据变化时只移动受影响的行, k 行变化的代价为 O(k log n), 不整体重排
+ *  源模型删除行时需要平移行号, 为 O(n) 的顺序扫描; 源模型只在末尾追加, 插入不平移
+ *  排序列和过滤列登记到 TableModel, 这两列被用户隐藏后仍会收到变化通知
+ */
+class LiveProxyModel : public QAbstractProxyModel {
+public:
+    LiveProxyModel(QObject *parent = Q_NULLPTR);
+
+    virtual void setSourceModel(QAbstractItemModel *source) override;
+    virtual void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    //只显示 column 列显示文字属于 texts 的行, texts 为空时不过滤
+    void set_filter(int column, const QStringList &texts);
+    int filter_column() const { return filter_column_; }
+    QStringList filter_texts() const { return filter_texts_.values(); }
+
+    virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    virtual QModelIndex parent(const QModelIndex &child) const override;
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    virtual QModelIndex mapToSource(const QModelIndex &proxy_index) const override;
+    virtual QModelIndex mapFromSource(const QModelIndex &source_index) const override;
+
+private:
+    //排序键的种类, 升序时依次排列; NaN 无法与数值比较, 单独排在数值之后
+    enum KeyRank { RANK_NUMBER = 0, RANK_NAN, RANK_TEXT };
+
+    struct SortKey {
+        int rank;
+        double number;
+        QString text;
+    };
+
+    void rebuild();
+    void watch_key_fields();
+    void refresh_key(int source_row);
+    bool accepts(int source_row) const;
+    bool less(int a, int b) const; //按排序键比较两个源行, 相等时按源行号
+    int position(int source_row) const;
+    int lower_bound(int first, int last, int source_row) const;
+
+    void on_data_changed(const QModelIndex &top_left, const QModelIndex &bottom_right);
+    void on_rows_inserted(const QModelIndex &parent, int first, int last);
+    void on_rows_about_to_be_removed(const QModelIndex &parent, int first, int last);
+    void on_rows_removed(const QModelIndex &parent, int first, int last);
+
+private:
+    int sort_column_ = -1;
+    Qt::SortOrder sort_order_ = Qt::AscendingOrder;
+    int filter_column_ = -1;
+    QSet<QString> filter_texts_;
+
+    //按源行号
+    QVector<SortKey> keys_;
+    QVector<bool> accepted_;
+    //按显示顺序排列的源行号
+    QVector<int> rows_;
+};
+
+#endif //__LIVE_PROXY_MODEL_H__
@@ -0,0 +1,78 @@
+#include "record_conflator.h"
+
+RecordConflator::RecordConflator() {
+    for (int type = 0; type < ELEMENT_TYPE_COUNT; type++) conflated_[type] = true;
+}
+
+void RecordConflator::set_conflated(int type, bool conflated) {
+    if (type < 0 || type >= ELEMENT_TYPE_COUNT) return;
+    conflated_[type] = conflated;
+}
+
+bool RecordConflator::is_conflated(int type) const {
+    if (type < 0 || type >= ELEMENT_TYPE_COUNT) return false;
+    return conflated_[type];
+}
+
+bool RecordConflator::is_empty(int type) const {
+    if (type < 0 || type >= ELEMENT_TYPE_COUNT) return true;
+    return records_[type].isEmpty();
+}
+
+void RecordConflator::clear() {
+    for (int type = 0; type < ELEMENT_TYPE_COUNT; type++) {
+        records_[type].resize(0);
+        map_key_index_[type].clear();
+    }
+    pending_ = 0;
+}
+
+void RecordConflator::add(const ElementRecord *records, int count) {
+    received_ += count;
+
+    for (int i = 0; i < count; i++) {
+        const ElementRecord &record = records[i];
+        if (record.type < 0 || record.type >= ELEMENT_TYPE_COUNT) continue;
+
+        QVector<ElementRecord> &list = records_[record.type];
+        if (conflated_[record.type]) {
+            //已有同主键记录时原地覆盖, 保留其在队列中的位置
+            QHash<qint64, int> &map_index = map_key_index_[record.type];
+            auto var = map_index.constFind(record.key);
+            if (var != map_index.constEnd()) {
+                list[var.value()] = record;
+                conflated_records_++;
+                continue;
+            }
+            map_index.insert(record.key, list.size());
+        }
+        list.append(record);
+        pending_++;
+    }
+}
+
+int RecordConflator::take(QVector<ElementRecord> *precords) {
+    int count = pending_;
+    if (count == 0) return 0;
+
+    precords->reserve(precords->size() + count);
+    for (int type = 0; type < ELEMENT_TYPE_COUNT; type++) take(type, precords);
+
+    return count;
+}
+
+int RecordConflator::take(int type, QVector<ElementRecord> *precords) {
+    if (type < 0 || type >= ELEMENT_TYPE_COUNT) return 0;
+
+    QVector<ElementRecord> &list = records_[type];
+    int count = list.size();
+    if (count == 0) return 0;
+
+    precords->append(list);
+    //保留容量, 下一帧不再重新分配
+    list.resize(0);
+    map_key_index_[type].clear();
+    pending_ -= count;
+
+    return count;
+}
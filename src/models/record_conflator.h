@@ -0,0 +1,47 @@
+#ifndef __RECORD_CONFLATOR_H__
+#define __RECORD_CONFLATOR_H__
+
+#include <QHash>
+#include <QVector>
+
+#include "element_record.h"
+#include "elements.h"
+
+/*
+ *  两次界面刷新之间按 (类型, 主键) 合并记录, 同一装备只保留最新值
+ *  界面每帧的工作量只与变化的装备数有关, 与报文速率无关
+ *  关闭合并的类型(如追加模式的表格)按到达顺序全部保留
+ */
+class RecordConflator {
+public:
+    RecordConflator();
+
+    void set_conflated(int type, bool conflated);
+    void clear();
+    bool is_conflated(int type) const;
+
+    void add(const ElementRecord *records, int count);
+    void add(const QVector<ElementRecord> &records) { add(records.constData(), records.size()); }
+
+    //取出待处理记录, 按类型分组, 同类型内保持首次到达的顺序
+    int take(QVector<ElementRecord> *precords);
+    //只取出一种类型, 其余类型继续合并
+    int take(int type, QVector<ElementRecord> *precords);
+
+    bool is_empty() const { return pending_ == 0; }
+    bool is_empty(int type) const;
+    int pending() const { return pending_; }
+    quint64 received() const { return received_; }
+    quint64 conflated() const { return conflated_records_; } //被更新值覆盖的记录数
+
+private:
+    bool conflated_[ELEMENT_TYPE_COUNT];
+    QVector<ElementRecord> records_[ELEMENT_TYPE_COUNT];
+    QHash<qint64, int> map_key_index_[ELEMENT_TYPE_COUNT]; //主键 -> records_ 下标
+    int pending_ = 0;
+
+    quint64 received_ = 0;
+    quint64 conflated_records_ = 0;
+};
+
+#endif //__RECORD_CONFLATOR_H__
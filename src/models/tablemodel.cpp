@@ -1,410 +1,379 @@
 #include "tablemodel.h"
 
-TableModel::TableModel(QObject *parent) {
-    if (!init_text_data()) exit(0);
-}
+#include <algorithm>
 
-TableModel::~TableModel() {
-    if (Q_NULLPTR != phor_head_data_) delete phor_head_data_;
+TableModel::TableModel(QObject *parent) : QAbstractTableModel(parent), registry_(ElementRegistry::instance()) {}
 
-    for (auto var : map_headnames_) {
-        delete var;
-    }
+TableModel::~TableModel() {}
 
-    for (auto var : map_variants_) {
-        delete var;
-    }
+void TableModel::add_data(const void *pdata, ElementType type) {
+    const ElementDescriptor *pdesc = prepare_layout(type);
+    if (pdesc == Q_NULLPTR) return;
 
-    for (auto var : map_para_choose_) {
-        delete var;
-    }
+    upsert_record(*pdesc, pdata);
 }
 
-#define STRING_PUSH(var)      \
-    {                         \
-        val0.append(var);     \
-        val1.push_back(val0); \
-        val0.clear();         \
+void TableModel::add_batch(const void *precords, int count, size_t stride, ElementType type) {
+    const ElementDescriptor *pdesc = prepare_layout(type);
+    if (pdesc == Q_NULLPTR || count <= 0) return;
+
+    //首批数据一次分配到位, 之后多为原地更新, 交给容器按倍数增长
+    if (store_.record_count() == 0) {
+        store_.reserve(count);
+        dirty_fields_.reserve(count);
+        if (mode_ == UPSERT_MODE) map_key_rows_.reserve(count);
     }
-void TableModel::add_data(void *pdata, ElementType type) {
-    QVariant *pvar = Q_NULLPTR;
-    QVariantList val0;
-    QVariantList val1;
-
-    switch (type) {
-        case SYSTEM_STATE: {
-            SystemState *data = static_cast<SystemState *>(pdata);
-
-            if (map_para_choose_.contains("power_off")) {
-                auto var = map_para_choose_.find("power_off");
-                STRING_PUSH(var.value()->at(data->power_off))
-            } else {
-                STRING_PUSH("")
-            }
 
-            //受控状态
-            if (map_para_choose_.contains("control_status")) {
-                auto var = map_para_choose_.find("control_status");
-                STRING_PUSH(var.value()->at(data->control_state))
-            } else {
-                STRING_PUSH("")
-            }
+    const char *base = static_cast<const char *>(precords);
+    for (int i = 0; i < count; i++) {
+        upsert_record(*pdesc, base + i * stride);
+    }
+}
 
-            //天线扫描方式
-            if (map_para_choose_.contains("scanning_mode")) {
-                auto var = map_para_choose_.find("scanning_mode");
-                STRING_PUSH(var.value()->at(data->scanning_mode))
-            } else {
-                STRING_PUSH("")
-            }
+const ElementDescriptor *TableModel::prepare_layout(ElementType type) {
+    const ElementDescriptor *pdesc = element_descriptor(type);
+    if (pdesc == Q_NULLPTR) return Q_NULLPTR;
 
-            //其他
-            STRING_PUSH(data->antenna_eleva_angle)
-            STRING_PUSH(data->beam_eleva_angle)
-            STRING_PUSH(data->eccm_measures)
-            STRING_PUSH(data->clutter_map)
-            STRING_PUSH(data->emi_intensity)
-            STRING_PUSH(data->time_alloca_state)
-            STRING_PUSH(data->track_data_rate)
-
-            if (!map_variants_.contains(SYSTEM_STATE)) {
-                pvar = new QVariant();
-                map_variants_.insert(SYSTEM_STATE, pvar);
-            } else {
-                pvar = map_variants_[SYSTEM_STATE];
-            }
-            pvar->setValue(val1);
-            break;
-        }
-        case WORK_PATTERN: {
-            WorkPattern *data = static_cast<WorkPattern *>(pdata);
-
-            if (!map_variants_.contains(WORK_PATTERN)) {
-                pvar = new QVariant();
-                map_variants_.insert(WORK_PATTERN, pvar);
-            } else {
-                pvar = map_variants_[WORK_PATTERN];
-            }
+    if (pdesc_ != pdesc) {
+        this->beginResetModel();
+        init_layout(*pdesc);
+        this->endResetModel();
+    }
+    return pdesc;
+}
+
+void TableModel::add_records(const ElementRecord *records, int count) {
+    if (count <= 0) return;
 
-            val0.append(data->id);
-            val0.append(data->start_yaw);
-            val0.append(data->end_yaw);
-            val1.push_back(val0);
+    //同一模型只接收一种类型, 未设置表头时以第一条记录为准
+    const ElementDescriptor *pdesc = (pdesc_ != Q_NULLPTR) ? pdesc_ : prepare_layout(ElementType(records[0].type));
+    if (pdesc == Q_NULLPTR) return;
 
-            pvar->setValue(val1);
-            break;
+    for (int i = 0; i < count; i++) {
+        const ElementRecord &record = records[i];
+        if (record.type != pdesc->type) continue;
+        if (record.flags & RECORD_REMOVED) {
+            remove_key(record.key);
+            continue;
         }
-        case RADIATION_STATE: {
-            RadiationState *data = static_cast<RadiationState *>(pdata);
-
-            if (!map_variants_.contains(RADIATION_STATE)) {
-                pvar = new QVariant();
-                map_variants_.insert(RADIATION_STATE, pvar);
-            } else {
-                pvar = map_variants_[RADIATION_STATE];
-            }
 
-            val0.append(data->equipment_id);
-            if (map_para_choose_.contains("radiation_state")) {
-                auto var = map_para_choose_.find("radiation_state");
-                val0.append(var.value()->at(data->radiation_state));
-            } else {
-                val0.append("");
-            }
-            val1.push_back(val0);
+        int rec = find_or_append(record.key);
+        mark_dirty(rec, store_.write_packed(rec, *pdesc, record.payload));
+    }
+}
 
-            pvar->setValue(val1);
-            break;
-        }
-        case WORK_FREQUENCY: {
-            WorkFrequency *data = static_cast<WorkFrequency *>(pdata);
-
-            if (!map_variants_.contains(WORK_FREQUENCY)) {
-                pvar = new QVariant();
-                map_variants_.insert(WORK_FREQUENCY, pvar);
-            } else {
-                pvar = map_variants_[WORK_FREQUENCY];
-            }
+void TableModel::upsert_record(const ElementDescriptor &desc, const void *pdata) {
+    int rec = find_or_append(element_key(desc, pdata));
 
-            val0.append(data->id);
-            val0.append(data->frequency_point);
-            val1.push_back(val0);
+    //按描述表原地写入字段, 只记录变化, 由 update() 统一通知视图
+    mark_dirty(rec, store_.write(rec, desc, pdata));
+}
 
-            pvar->setValue(val1);
-            break;
-        }
-        case DISTURB_DIRECTION: {
-            DisturbDirection *data = static_cast<DisturbDirection *>(pdata);
-
-            if (!map_variants_.contains(DISTURB_DIRECTION)) {
-                pvar = new QVariant();
-                map_variants_.insert(DISTURB_DIRECTION, pvar);
-            } else {
-                pvar = map_variants_[DISTURB_DIRECTION];
-            }
+int TableModel::find_or_append(qint64 key) {
+    //按主键查找已有记录, 找不到时追加到未发布区域
+    int rec = (mode_ == UPSERT_MODE) ? map_key_rows_.value(key, -1) : -1;
+    if (rec < 0) {
+        rec = store_.append_record();
+        dirty_fields_.append(0);
+        if (mode_ == UPSERT_MODE) map_key_rows_.insert(key, rec);
+    }
+    return rec;
+}
 
-            val0.append(data->id);
-            val0.append(data->eleva_angle);
-            val0.append(data->pitch);
-            val0.append(data->power);
-            val1.push_back(val0);
+void TableModel::remove_data(const void *pdata, ElementType type) {
+    if (pdesc_ == Q_NULLPTR || pdesc_->type != type) return;
+    remove_key(element_key(*pdesc_, pdata));
+}
 
-            pvar->setValue(val1);
-            break;
-        }
-        case REGION_OF_SEARCH: {
-            RegionOfSearch *data = static_cast<RegionOfSearch *>(pdata);
-
-            if (!map_variants_.contains(REGION_OF_SEARCH)) {
-                pvar = new QVariant();
-                map_variants_.insert(REGION_OF_SEARCH, pvar);
-            } else {
-                pvar = map_variants_[REGION_OF_SEARCH];
-            }
+void TableModel::remove_key(qint64 key) {
+    if (mode_ != UPSERT_MODE) return;
 
-            //设置表格数据
-            pvar->setValue(val1);
-            break;
-        }
-        case CHAIN_OF_COMMAND: {
-            ChainOfCommand *data = static_cast<ChainOfCommand *>(pdata);
-
-            if (!map_variants_.contains(CHAIN_OF_COMMAND)) {
-                pvar = new QVariant();
-                map_variants_.insert(CHAIN_OF_COMMAND, pvar);
-            } else {
-                pvar = map_variants_[CHAIN_OF_COMMAND];
-            }
+    auto var = map_key_rows_.find(key);
+    if (var == map_key_rows_.end()) return;
 
-            if (map_para_choose_.contains("work_state")) {
-                auto var = map_para_choose_.find("work_state");
-                STRING_PUSH(var.value()->at(data->work_state))
-            } else {
-                STRING_PUSH("")
-            }
+    int rec = var.value();
+    map_key_rows_.erase(var);
+    dirty_fields_[rec] |= RECORD_REMOVED;
+    pending_removals_.append(rec);
+}
 
-            STRING_PUSH(data->war_preparedness_lv)
+void TableModel::mark_dirty(int rec, quint32 fields) {
+    //尚未发布的记录会随插入一并通知, 停放时和隐藏字段(排序、过滤字段除外)不记录
+    fields &= ~(hidden_fields_ & ~watched_fields_);
+    if (parked_ || fields == 0 || rec >= published_) return;
 
-            if (map_para_choose_.contains("equip_statu")) {
-                auto var = map_para_choose_.find("equip_statu");
-                STRING_PUSH(var.value()->at(data->equip_state))
-            } else {
-                STRING_PUSH("")
-            }
-            if (map_para_choose_.contains("combat_permissions")) {
-                auto var = map_para_choose_.find("combat_permissions");
-                STRING_PUSH(var.value()->at(data->combat_permissions))
-            } else {
-                STRING_PUSH("")
-            }
-            if (map_para_choose_.contains("command_mode")) {
-                auto var = map_para_choose_.find("command_mode");
-                STRING_PUSH(var.value()->at(data->command_mode))
-            } else {
-                STRING_PUSH("")
-            }
+    if (dirty_fields_.at(rec) == 0) dirty_records_.append(rec);
+    dirty_fields_[rec] |= fields;
+}
 
-            pvar->setValue(val1);
-            break;
-        }
-        case PHOTOELECTRICITY_EQUIPMENT: {
-            PhotoelectricityEquipment *data = static_cast<PhotoelectricityEquipment *>(pdata);
-
-            STRING_PUSH(data->id)
-            STRING_PUSH(data->lon)
-            STRING_PUSH(data->lat)
-            STRING_PUSH(data->alt)
-            STRING_PUSH(data->elevation_angle)
-            STRING_PUSH(data->pitch_angle)
-            if (map_para_choose_.contains("trace_status")) {
-                auto var = map_para_choose_.find("trace_status");
-                STRING_PUSH(var.value()->at(data->trace_status))
-            } else {
-                STRING_PUSH("")
-            }
+void TableModel::set_insert_mode(InsertMode mode) {
+    mode_ = mode;
+    map_key_rows_.clear();
+    if (mode_ != UPSERT_MODE) return;
 
-            if (!map_variants_.contains(PHOTOELECTRICITY_EQUIPMENT)) {
-                pvar = new QVariant();
-                map_variants_.insert(PHOTOELECTRICITY_EQUIPMENT, pvar);
-            } else {
-                pvar = map_variants_[PHOTOELECTRICITY_EQUIPMENT];
-            }
-            pvar->setValue(val1);
-            break;
-        }
-        case DESCRIPTION_OF_INTERCEPTOR_WEAPON: {
-            DescriptionOfInterceptorWeapon *data = static_cast<DescriptionOfInterceptorWeapon *>(pdata);
-
-            if (map_para_choose_.contains("work_state")) {
-                auto var = map_para_choose_.find("work_state");
-                STRING_PUSH(var.value()->at(data->status));
-            } else {
-                STRING_PUSH("")
-            }
-            STRING_PUSH(data->war_readiness_lv);
-            if (map_para_choose_.contains("combat_permissions")) {
-                auto var = map_para_choose_.find("combat_permissions");
-                STRING_PUSH(var.value()->at(data->operational_authority));
-            } else {
-                STRING_PUSH("")
-            }
-            if (map_para_choose_.contains("command_mode")) {
-                auto var = map_para_choose_.find("command_mode");
-                STRING_PUSH(var.value()->at(data->command_mode));
-            } else {
-                STRING_PUSH("")
-            }
-            STRING_PUSH(data->app_mode)
-            if (map_para_choose_.contains("power_off")) {
-                auto var = map_para_choose_.find("power_off");
-                STRING_PUSH(var.value()->at(data->run_status));
-            } else {
-                STRING_PUSH("")
-            }
+    //切换回更新模式时, 已有记录中后出现的同主键记录生效
+    for (int rec = 0; rec < store_.record_count(); rec++) {
+        map_key_rows_.insert(record_key(rec), rec);
+    }
+}
 
-            if (!map_variants_.contains(DESCRIPTION_OF_INTERCEPTOR_WEAPON)) {
-                pvar = new QVariant();
-                map_variants_.insert(DESCRIPTION_OF_INTERCEPTOR_WEAPON, pvar);
-            } else {
-                pvar = map_variants_[DESCRIPTION_OF_INTERCEPTOR_WEAPON];
-            }
-            pvar->setValue(val1);
-            break;
-        }
-        case GBI_RESOURCES: {
-            //拦截弹资源
-            GBIResources *data = static_cast<GBIResources *>(pdata);
-
-            val0.push_back(data->id);
-            val0.push_back(data->bullet_quantity);
-            val1.push_back(val0);
-
-            if (!map_variants_.contains(GBI_RESOURCES)) {
-                pvar = new QVariant();
-                map_variants_.insert(GBI_RESOURCES, pvar);
-            } else {
-                pvar = map_variants_[GBI_RESOURCES];
-            }
-            pvar->setValue(val1);
-            break;
-        }
-        case GUIDANCE_RADAR: {
-            //制导雷达
-            GuidanceRadar *data = static_cast<GuidanceRadar *>(pdata);
-
-            val0.push_back(data->id);
-            val0.push_back(data->res_occu_rate);
-            val1.push_back(val0);
-
-            if (!map_variants_.contains(GUIDANCE_RADAR)) {
-                pvar = new QVariant();
-                map_variants_.insert(GUIDANCE_RADAR, pvar);
-            } else {
-                pvar = map_variants_[GUIDANCE_RADAR];
-            }
-            pvar->setValue(val1);
-            break;
-        }
-        case FIREPOWER_UNIT: {
-            FirepowerUnit *data = static_cast<FirepowerUnit *>(pdata);
-
-            if (map_para_choose_.contains("work_state")) {
-                auto var = map_para_choose_.find("work_state");
-                STRING_PUSH(var.value()->at(data->lon));
-            } else {
-                STRING_PUSH("")
-            }
+qint64 TableModel::record_key(int rec) const {
+    quint64 key = 0;
+    for (int i = 0; i < 2; i++) {
+        int field = pdesc_->key_fields[i];
+        if (field < 0) continue;
+        key = (key << 32) | static_cast<quint32>(store_.int_at(field, rec));
+    }
+    return static_cast<qint64>(key);
+}
 
-            if (map_para_choose_.contains("command_mode")) {
-                auto var = map_para_choose_.find("command_mode");
-                STRING_PUSH(var.value()->at(data->command_mode));
-            } else {
-                STRING_PUSH("")
-            }
+void TableModel::begin_insert_records(int first, int last) {
+    if (local_ == VERTICAL_HEAD)
+        this->beginInsertColumns(QModelIndex(), first, last);
+    else
+        this->beginInsertRows(QModelIndex(), first, last);
+}
 
-            STRING_PUSH(data->oper_task);
+void TableModel::end_insert_records() {
+    if (local_ == VERTICAL_HEAD)
+        this->endInsertColumns();
+    else
+        this->endInsertRows();
+}
 
-            if (map_para_choose_.contains("inter_ception_mode")) {
-                auto var = map_para_choose_.find("inter_ception_mode");
-                STRING_PUSH(var.value()->at(data->inter_ception_mode));
-            } else {
-                STRING_PUSH("")
-            }
+QModelIndex TableModel::cell_index(int rec, int field) const {
+    return (local_ == VERTICAL_HEAD) ? this->index(field, rec) : this->index(rec, field);
+}
 
-            STRING_PUSH(data->frequency_point_id);
+void TableModel::begin_remove_records(int first, int last) {
+    if (local_ == VERTICAL_HEAD)
+        this->beginRemoveColumns(QModelIndex(), first, last);
+    else
+        this->beginRemoveRows(QModelIndex(), first, last);
+}
 
-            STRING_PUSH(data->sector_central_angle);
+void TableModel::end_remove_records() {
+    if (local_ == VERTICAL_HEAD)
+        this->endRemoveColumns();
+    else
+        this->endRemoveRows();
+}
 
-            if (!map_variants_.contains(FIREPOWER_UNIT)) {
-                pvar = new QVariant();
-                map_variants_.insert(FIREPOWER_UNIT, pvar);
-            } else {
-                pvar = map_variants_[FIREPOWER_UNIT];
-            }
-            pvar->setValue(val1);
-            break;
+void TableModel::emit_changed(int first, int last, quint32 fields) {
+    //连续变化的字段合并为一个区间
+    fields &= ~RECORD_REMOVED;
+    int field = 0;
+    while (fields != 0) {
+        while (!(fields & 1u)) {
+            fields >>= 1;
+            field++;
         }
-        case FIREPOWER_UNIT_AISLE: {
-            FirepowerUnitAisle *data = static_cast<FirepowerUnitAisle *>(pdata);
-
-            val0.append(data->unit_id);
-            val0.append(data->target_id);
-            if (map_para_choose_.contains("firepower_status")) {
-                auto var = map_para_choose_.find("firepower_status");
-                val0.append(var.value()->at(data->status));
-            } else {
-                val0.append("");
-            }
-            val1.push_back(val0);
-
-            if (!map_variants_.contains(FIREPOWER_UNIT_AISLE)) {
-                pvar = new QVariant();
-                map_variants_.insert(FIREPOWER_UNIT_AISLE, pvar);
-            } else {
-                pvar = map_variants_[FIREPOWER_UNIT_AISLE];
-            }
-            pvar->setValue(val1);
-            break;
+        int begin = field;
+        while (fields & 1u) {
+            fields >>= 1;
+            field++;
         }
-        default:
-            break;
+        emit dataChanged(cell_index(first, begin), cell_index(last, field - 1));
     }
-
-    view_data(pvar);
 }
 
 bool TableModel::set_head_data(ElementType type, HeadLocal local) {
-    if (type < 0) return false;
+    const ElementDescriptor *pdesc = element_descriptor(type);
+    if (pdesc == Q_NULLPTR) return false;
 
     pver_head_data_ = Q_NULLPTR;
     phor_head_data_ = Q_NULLPTR;
 
-    if (local == VERTICAL_HEAD && map_headnames_.contains(type))
-        pver_head_data_ = map_headnames_[type];
-    else if (local == HORIZONTAL_HEAD && map_headnames_.contains(type))
-        phor_head_data_ = map_headnames_[type];
+    const QStringList *names = registry_.head_names(type);
+    if (names == Q_NULLPTR) return false;
+
+    if (local == VERTICAL_HEAD)
+        pver_head_data_ = names;
     else
-        return false;
+        phor_head_data_ = names;
+
+    this->beginResetModel();
+    local_ = local;
+    init_layout(*pdesc);
+    this->endResetModel();
 
     return true;
 }
 
-void TableModel::update() {
+void TableModel::set_parked(bool parked) {
+    if (parked_ == parked) return;
+    parked_ = parked;
+    if (parked_) return;
+
+    //停放期间的变化没有逐条记录, 整体重置一次视图
     this->beginResetModel();
+    drop_removed_records();
+    published_ = store_.record_count();
+    dirty_fields_.fill(0);
+    dirty_records_.clear();
     this->endResetModel();
 }
 
-QVariant TableModel::data(const QModelIndex &index, int role) const {
-    int row = index.row();
-    int column = index.column();
+void TableModel::set_field_visible(int field, bool visible) {
+    if (field < 0 || field >= store_.field_count()) return;
+
+    quint32 bit = 1u << field;
+    if (visible == !(hidden_fields_ & bit)) return;
+
+    if (!visible) {
+        hidden_fields_ |= bit;
+        return;
+    }
+
+    //隐藏期间没有通知, 重新显示时整列刷新一次
+    hidden_fields_ &= ~bit;
+    int records = (local_ == VERTICAL_HEAD) ? columnCount() : rowCount();
+    if (!parked_ && records > 0) emit_changed(0, records - 1, bit);
+}
+
+void TableModel::drop_removed_records() {
+    //不通知视图, 只在重置模型时使用
+    if (pending_removals_.isEmpty()) return;
+
+    std::sort(pending_removals_.begin(), pending_removals_.end());
+    int i = pending_removals_.size() - 1;
+    while (i >= 0) {
+        int last = pending_removals_.at(i);
+        int first = last;
+        while (i > 0 && pending_removals_.at(i - 1) == first - 1) first = pending_removals_.at(--i);
+        i--;
+
+        store_.remove_records(first, last - first + 1);
+        dirty_fields_.remove(first, last - first + 1);
+    }
+    pending_removals_.clear();
+
+    map_key_rows_.clear();
+    if (mode_ != UPSERT_MODE) return;
+    for (int rec = 0; rec < store_.record_count(); rec++) map_key_rows_.insert(record_key(rec), rec);
+}
+
+void TableModel::clear_data() {
+    if (pdesc_ == Q_NULLPTR) return;
+
+    quint32 hidden = hidden_fields_;
+    this->beginResetModel();
+    init_layout(*pdesc_);
+    hidden_fields_ = hidden;
+    this->endResetModel();
+}
 
+void TableModel::update() {
+    if (parked_) return;
+
+    // 1.删除: 从后往前按连续区间删除, 保证前面的下标不变
+    if (!pending_removals_.isEmpty()) {
+        std::sort(pending_removals_.begin(), pending_removals_.end());
+        int i = pending_removals_.size() - 1;
+        while (i >= 0) {
+            int last = pending_removals_.at(i);
+            int first = last;
+            while (i > 0 && pending_removals_.at(i - 1) == first - 1) first = pending_removals_.at(--i);
+            i--;
+
+            //未发布部分视图不可见, 直接删除
+            if (last >= published_) {
+                int begin = qMax(first, published_);
+                store_.remove_records(begin, last - begin + 1);
+                dirty_fields_.remove(begin, last - begin + 1);
+                last = begin - 1;
+            }
+            if (first <= last) {
+                begin_remove_records(first, last);
+                store_.remove_records(first, last - first + 1);
+                dirty_fields_.remove(first, last - first + 1);
+                published_ -= last - first + 1;
+                end_remove_records();
+            }
+        }
+        pending_removals_.clear();
+
+        //下标已移动, 重建主键索引和脏记录列表
+        map_key_rows_.clear();
+        dirty_records_.clear();
+        for (int rec = 0; rec < store_.record_count(); rec++) {
+            if (mode_ == UPSERT_MODE) map_key_rows_.insert(record_key(rec), rec);
+            if (dirty_fields_.at(rec) != 0) dirty_records_.append(rec);
+        }
+    }
+
+    // 2.更新: 相邻且变化字段相同的记录合并为一个矩形区域
+    if (!dirty_records_.isEmpty()) {
+        std::sort(dirty_records_.begin(), dirty_records_.end());
+        int i = 0;
+        while (i < dirty_records_.size()) {
+            int first = dirty_records_.at(i);
+            quint32 fields = dirty_fields_.at(first);
+            int last = first;
+            while (i + 1 < dirty_records_.size() && dirty_records_.at(i + 1) == last + 1 &&
+                   dirty_fields_.at(last + 1) == fields) {
+                last = dirty_records_.at(++i);
+            }
+            i++;
+
+            emit_changed(first, last, fields);
+            for (int rec = first; rec <= last; rec++) dirty_fields_[rec] = 0;
+        }
+        dirty_records_.clear();
+    }
+
+    // 3.插入: 新记录都在末尾, 一次性发布
+    if (store_.record_count() > published_) {
+        begin_insert_records(published_, store_.record_count() - 1);
+        published_ = store_.record_count();
+        end_insert_records();
+    }
+}
+
+QVariant TableModel::data(const QModelIndex &index, int role) const {
     if (!index.isValid()) return QVariant();
 
-    if (role == Qt::DisplayRole || role == Qt::EditRole) {
-        if (row >= data_.size()) return QVariant();
-        if (column >= data_.at(row).size()) return QVariant();
+    int field = (local_ == VERTICAL_HEAD) ? index.row() : index.column();
+    int record = (local_ == VERTICAL_HEAD) ? index.column() : index.row();
+    if (record >= published_) return QVariant();
 
-        return data_.at(row).at(column);
+    return cell_data(field, record, role);
+}
+
+QVariant TableModel::cell_data(int field, int record, int role) const {
+    if (role == RAW_VALUE_ROLE) {
+        //排序使用原始值, 枚举按代码排序
+        if (field >= store_.field_count()) return QVariant();
+        switch (store_.kind(field)) {
+            case FIELD_INT:
+            case FIELD_ENUM:
+                return store_.int_at(field, record);
+            case FIELD_DOUBLE:
+                return store_.double_at(field, record);
+            case FIELD_STRING:
+                return store_.string_at(field, record);
+        }
+        return QVariant();
+    } else if (role == Qt::DisplayRole || role == Qt::EditRole || role == LABEL_TEXT_ROLE) {
+        if (field >= store_.field_count()) return QVariant();
+        if (role != LABEL_TEXT_ROLE && (hidden_fields_ & (1u << field))) return QVariant();
+
+        //只在视图请求时才把原始值转换为显示内容, 数值的显示文字按单元格缓存, 重绘时不再格式化
+        bool display = (role != Qt::EditRole);
+        switch (store_.kind(field)) {
+            case FIELD_INT:
+                return display ? QVariant(store_.text_at(field, record)) : QVariant(store_.int_at(field, record));
+            case FIELD_DOUBLE:
+                return display ? QVariant(store_.text_at(field, record)) : QVariant(store_.double_at(field, record));
+            case FIELD_STRING:
+                return store_.string_at(field, record);
+            case FIELD_ENUM: {
+                //实时数据中的代码可能超出文字表, 显示兜底文字
+                const QString *ptext = field_labels_.at(field).find(store_.int_at(field, record));
+                return (ptext != Q_NULLPTR) ? *ptext : registry_.unknown_label();
+            }
+        }
+        return QVariant();
     } else if (role == Qt::TextAlignmentRole) {
         return Qt::AlignCenter;
     } else {
@@ -412,211 +381,50 @@ QVariant TableModel::data(const QModelIndex &index, int role) const {
     }
 }
 
-int TableModel::rowCount(const QModelIndex &parent) const { return data_.size(); }
+QStringList TableModel::field_label_texts(int field) const {
+    QStringList texts;
+    if (field < 0 || field >= field_labels_.size()) return texts;
+
+    const LabelTable &table = field_labels_.at(field);
+    for (int i = 0; i < table.count; i++) texts << table.texts[i];
+    return texts;
+}
+
+int TableModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return (local_ == VERTICAL_HEAD) ? store_.field_count() : published_;
+}
 
 int TableModel::columnCount(const QModelIndex &parent) const {
-    if (data_.isEmpty())
-        return -1;
-    else
-        return data_.at(0).size();
+    if (parent.isValid()) return 0;
+    return (local_ == VERTICAL_HEAD) ? published_ : store_.field_count();
 }
 
 QVariant TableModel::headerData(int section, Qt::Orientation orientation, int role) const {
     if (role != Qt::DisplayRole) return QVariant();
 
     if (orientation == Qt::Vertical && Q_NULLPTR != pver_head_data_)
-        return pver_head_data_->at(section);
+        return pver_head_data_->value(section);
     else if (orientation == Qt::Horizontal && Q_NULLPTR != phor_head_data_)
-        return phor_head_data_->at(section);
+        return phor_head_data_->value(section);
 
     return QVariant();
 }
 
-bool TableModel::view_data(QVariant *pother_data) {
-    QVariantList var_rows = pother_data->toList(); //获得二维数组
-    if (var_rows.isEmpty()) return false;
+void TableModel::init_layout(const ElementDescriptor &desc) {
+    pdesc_ = &desc;
+    store_.set_layout(desc);
 
-    for (int i = 0; i < var_rows.size(); i++) {
-        QVariantList buf = var_rows.at(i).toList();
-        data_.push_back(buf);
+    //枚举文字表在这里解析一次, 取值时直接按指针访问
+    field_labels_.resize(desc.field_count);
+    for (int i = 0; i < desc.field_count; i++) {
+        field_labels_[i] = registry_.labels(desc.fields[i].labels);
     }
 
-    return true;
-}
-
-bool TableModel::init_text_data() {
-    QStringList *sl = new QStringList();
-
-    // 1.初始化表头信息
-    //雷达系统状态数据描述
-    *sl << "开关机:"
-        << "受控状态:"
-        << "天线扫描方式:"
-        << "天线机械俯仰角:"
-        << "波束起始扫描仰角:"
-        << "抗干扰措施:"
-        << "杂波图:"
-        << "电磁干扰强度:"
-        << "时间资源分配状态:"
-        << "跟踪数据率:";
-    map_headnames_.insert(SYSTEM_STATE, sl);
-
-    //工作模式
-    sl = new QStringList();
-    *sl << "编号"
-        << "起始方位"
-        << "结束方位";
-    map_headnames_.insert(WORK_PATTERN, sl);
-
-    //辐射状态
-    sl = new QStringList();
-    *sl << "设备名称"
-        << "状态";
-    map_headnames_.insert(RADIATION_STATE, sl);
-
-    //工作频点
-    sl = new QStringList();
-    *sl << "编号"
-        << "频点";
-    map_headnames_.insert(WORK_FREQUENCY, sl);
-
-    //有源干扰方向
-    sl = new QStringList();
-    *sl << "编号"
-        << "俯仰角"
-        << "偏航角"
-        << "功率";
-    map_headnames_.insert(DISTURB_DIRECTION, sl);
-
-    //指控系统状态数据描述
-    sl = new QStringList();
-    *sl << "系统工作状态:"
-        << "战备值班等级:"
-        << "装备状态:"
-        << "作战权限:"
-        << "指挥方式:";
-    map_headnames_.insert(CHAIN_OF_COMMAND, sl);
-
-    //光电装备状态显示
-    sl = new QStringList();
-    *sl << "编号:"
-        << "经度:"
-        << "维度:"
-        << "高度:"
-        << "光学中心指向(俯仰角):"
-        << "光学中心指向(偏航角):"
-        << "搜索跟踪状态:";
-    map_headnames_.insert(PHOTOELECTRICITY_EQUIPMENT, sl);
-
-    //拦截武器显示
-    sl = new QStringList();
-    *sl << "工作状态:"
-        << "战备值班等级:"
-        << "作战权限:"
-        << "指挥方式:"
-        << "传感器应用方式:"
-        << "系统运行状态:"
-        << "传感器资源占用百分比:";
-    map_headnames_.insert(DESCRIPTION_OF_INTERCEPTOR_WEAPON, sl);
-
-    //拦截武器显示
-    sl = new QStringList();
-    *sl << "发射车id"
-        << "可用弹量";
-    map_headnames_.insert(GBI_RESOURCES, sl);
-
-    //制导雷达
-    sl = new QStringList();
-    *sl << "编号"
-        << "传感器资源占用百分比";
-    map_headnames_.insert(GUIDANCE_RADAR, sl);
-
-    //火力单元状态显示
-    sl = new QStringList();
-    *sl << "工作方式:"
-        << "指挥方式:"
-        << "作战任务:"
-        << "拦截方式:"
-        << "频点号:"
-        << "责任扇区中心角:";
-    map_headnames_.insert(FIREPOWER_UNIT, sl);
-
-    //火力单元通道状态
-    sl = new QStringList();
-    *sl << "火力单元编号"
-        << "跟踪目标编号"
-        << "状态";
-    map_headnames_.insert(FIREPOWER_UNIT_AISLE, sl);
-
-    ////////////////////////////////////////////////////////////////////
-
-    // 2.初始化成员状态信息
-    sl = new QStringList();
-    *sl << "开机"
-        << "待机"
-        << "关机";
-    map_para_choose_.insert("power_off", sl);
-
-    sl = new QStringList();
-    *sl << "本控"
-        << "遥控"
-        << "其他";
-    map_para_choose_.insert("control_status", sl);
-
-    sl = new QStringList();
-    *sl << "辐射"
-        << "静默"
-        << "闪烁";
-    map_para_choose_.insert("radiation_state", sl);
-
-    sl = new QStringList();
-    *sl << "圆圈顺时针"
-        << "圆圈逆时针"
-        << "扇扫"
-        << "驻留";
-    map_para_choose_.insert("scanning_mode", sl);
-
-    sl = new QStringList();
-    *sl << "作战"
-        << "训练"
-        << "试验"
-        << "值班";
-    map_para_choose_.insert("work_state", sl);
-
-    sl = new QStringList();
-    *sl << "正常"
-        << "降级"
-        << "故障";
-    map_para_choose_.insert("equip_statu", sl);
-
-    sl = new QStringList();
-    *sl << "允许自主射击"
-        << "人工射击";
-    map_para_choose_.insert("combat_permissions", sl);
-
-    sl = new QStringList();
-    *sl << "按级"
-        << "越级"
-        << "接替";
-    map_para_choose_.insert("command_mode", sl);
-
-    sl = new QStringList();
-    *sl << "手动"
-        << "引导"
-        << "闭环";
-    map_para_choose_.insert("trace_status", sl);
-
-    sl = new QStringList();
-    *sl << "人工"
-        << "自动";
-    map_para_choose_.insert("inter_ception_mode", sl);
-
-    sl = new QStringList();
-    *sl << "无效"
-        << "空闲"
-        << "占用"
-        << "拦截"
-        << "已拦";
-    map_para_choose_.insert("firepower_status", sl);
-    return true;
+    map_key_rows_.clear();
+    dirty_fields_.clear();
+    dirty_records_.clear();
+    pending_removals_.clear();
+    published_ = 0;
+    hidden_fields_ = 0;
 }
@@ -2,12 +2,25 @@
 #define __TABLEMODEL_H__
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QTableView>
 
+#include "column_store.h"
+#include "element_descriptor.h"
+#include "element_record.h"
+#include "element_registry.h"
 #include "elements.h"
 
 enum HeadLocal { VERTICAL_HEAD = 0, HORIZONTAL_HEAD };
 
+//追加模式: 每条数据新增一行; 更新模式: 按主键原地更新
+enum InsertMode { APPEND_MODE = 0, UPSERT_MODE };
+
+//取单元格原始值(枚举为代码), 供排序使用
+const int RAW_VALUE_ROLE = Qt::UserRole + 1;
+//取单元格显示文字, 不受字段隐藏影响, 供过滤使用
+const int LABEL_TEXT_ROLE = Qt::UserRole + 2;
+
 class TableModel : public QAbstractTableModel {
 public:
     TableModel(QObject *parent = Q_NULLPTR);
@@ -15,27 +28,104 @@ public:
     virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
-    void add_data(void *pdata, ElementType type);
+    //数据先写入存储并记录变化, 调用 update() 后才按区间通知视图
+    void add_data(const void *pdata, ElementType type);
+    void remove_data(const void *pdata, ElementType type);
+    //按主键删除, 只在更新模式下有效
+    virtual void remove_key(qint64 key);
+    template <typename T>
+    void add_data(const T &data) {
+        add_data(&data, ElementTraits<T>::type);
+    }
+
+    //批量写入同类型记录, 所有变化在下一次 update() 中合并通知
+    void add_batch(const void *precords, int count, size_t stride, ElementType type);
+    template <typename T>
+    void add_batch(const T *records, int count) {
+        add_batch(records, count, sizeof(T), ElementTraits<T>::type);
+    }
+    template <typename T>
+    void add_batch(const QVector<T> &records) {
+        add_batch(records.constData(), records.size());
+    }
+
+    //写入解码后的定长记录, 类型与模型不一致的记录被忽略, 带 RECORD_REMOVED 的记录按主键删除
+    void add_records(const ElementRecord *records, int count);
+    void add_record(const ElementRecord &record) { add_records(&record, 1); }
     bool set_head_data(ElementType type, HeadLocal local);
-    QStringList *get_row_name(int type) { return map_headnames_[type]; }
-    void update();
+    //清空全部记录, 保留表头和隐藏字段设置
+    void clear_data();
+    void set_insert_mode(InsertMode mode);
+    InsertMode insert_mode() const { return mode_; }
+    const QStringList *get_row_name(int type) const { return registry_.head_names(type); }
+    virtual void update();
+    //是否有尚未通知视图的变化
+    virtual bool has_pending() const {
+        return !parked_ &&
+               (!dirty_records_.isEmpty() || !pending_removals_.isEmpty() || published_ < store_.record_count());
+    }
+
+    //面板隐藏时只保存数据, 不记录变化也不通知视图; 重新显示时整体重置一次
+    virtual void set_parked(bool parked);
+    bool is_parked() const { return parked_; }
+    //用户隐藏的字段不再通知视图, 也不格式化
+    void set_field_visible(int field, bool visible);
+    //排序、过滤依赖的字段位掩码, 这些字段隐藏时仍通知, 代理模型据此移动行
+    void set_watched_fields(quint32 fields) { watched_fields_ = fields; }
+    HeadLocal head_local() const { return local_; }
+    //枚举字段的全部显示文字, 非枚举字段为空
+    QStringList field_label_texts(int field) const;
+    //写入时超出枚举文字表范围的代码次数
+    quint64 unknown_codes() const { return store_.unknown_codes(); }
 
 protected:
     virtual QVariant data(const QModelIndex &index, int role) const override;
     virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
-    bool view_data(QVariant *pother_data);
+    //存储中第 record 条记录的显示内容, 派生类按自己的行顺序映射后调用
+    QVariant cell_data(int field, int record, int role) const;
+
+    //派生类可替换记录的定位和变化记录方式, 存储和显示逻辑共用
+    virtual void init_layout(const ElementDescriptor &desc);
+    virtual int find_or_append(qint64 key);
+    virtual void mark_dirty(int rec, quint32 fields);
+    QModelIndex cell_index(int rec, int field) const;
+    void emit_changed(int first, int last, quint32 fields);
 
 private:
-    bool init_text_data();
+    const ElementDescriptor *prepare_layout(ElementType type);
+    void upsert_record(const ElementDescriptor &desc, const void *pdata);
+    qint64 record_key(int rec) const;
+
+    void begin_insert_records(int first, int last);
+    void end_insert_records();
+    void begin_remove_records(int first, int last);
+    void end_remove_records();
+    void drop_removed_records();
+
+protected:
+    const ElementDescriptor *pdesc_ = Q_NULLPTR;
+    HeadLocal local_ = HORIZONTAL_HEAD; //垂直表头时每条记录占一列
+    ColumnStore store_;
+    bool parked_ = false;
+    quint32 hidden_fields_ = 0; //用户隐藏的字段位掩码
+    quint32 watched_fields_ = 0;
 
 private:
-    QList<QList<QVariant>> data_;
-    QMap<int, QStringList *> map_headnames_;
-    QMap<int, QVariant *> map_variants_;
-    QMap<QString, QStringList *> map_para_choose_;
-    QStringList *phor_head_data_ = Q_NULLPTR;
-    QStringList *pver_head_data_ = Q_NULLPTR;
+    InsertMode mode_ = UPSERT_MODE;
+    QHash<qint64, int> map_key_rows_; //主键 -> 记录下标
+
+    //本批次变化, 每条记录一个字段位掩码, 最高位表示待删除
+    static const quint32 RECORD_REMOVED = 0x80000000u;
+    int published_ = 0; //视图可见的记录数, 其后为待插入记录
+    QVector<quint32> dirty_fields_;
+    QVector<int> dirty_records_;
+    QVector<int> pending_removals_;
+    QVector<LabelTable> field_labels_; //枚举字段的文字表, 非枚举字段为空表
+
+    const ElementRegistry &registry_;
+    const QStringList *phor_head_data_ = Q_NULLPTR;
+    const QStringList *pver_head_data_ = Q_NULLPTR;
 };
 
 #endif //__TABLEMODEL_H__
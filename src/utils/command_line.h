@@ -0,0 +1,60 @@
+#ifndef __COMMAND_LINE_H__
+#define __COMMAND_LINE_H__
+
+#include <QStringList>
+#include <QtGlobal>
+#include <climits>
+
+/*
+ *  "--name <取值>" 形式的命令行选项, 主程序和 tools 下的工具共用
+ *  以 "--" 开头的参数视为下一个选项而不是取值
+ */
+
+//选项后第 index 个取值, 选项不存在或缺少取值时返回空串
+inline QString arg_value(const QStringList &args, const QString &name, int index = 1) {
+    int pos = args.indexOf(name);
+    if (pos < 0) return QString();
+
+    for (int i = 1; i <= index; i++) {
+        if (pos + i >= args.size() || args.at(pos + i).startsWith("--")) return QString();
+    }
+    return args.at(pos + index);
+}
+
+/*
+ *  整数选项, 不存在时返回 fallback
+ *  取值不是整数或超出 [min, max] 时输出警告并返回 fallback, pok 置为 false
+ */
+inline int arg_int(const QStringList &args, const QString &name, int fallback, int min = INT_MIN, int max = INT_MAX,
+                   bool *pok = nullptr) {
+    if (pok != nullptr) *pok = true;
+    if (!args.contains(name)) return fallback;
+
+    bool ok = false;
+    QString text = arg_value(args, name);
+    int value = text.toInt(&ok);
+    if (ok && value >= min && value <= max) return value;
+
+    qWarning("%s: invalid value \"%s\", expected an integer in [%d, %d]", qPrintable(name), qPrintable(text), min,
+             max);
+    if (pok != nullptr) *pok = false;
+    return fallback;
+}
+
+//浮点选项, 规则同 arg_int
+inline double arg_double(const QStringList &args, const QString &name, double fallback, double min, double max,
+                         bool *pok = nullptr) {
+    if (pok != nullptr) *pok = true;
+    if (!args.contains(name)) return fallback;
+
+    bool ok = false;
+    QString text = arg_value(args, name);
+    double value = text.toDouble(&ok);
+    if (ok && value >= min && value <= max) return value;
+
+    qWarning("%s: invalid value \"%s\", expected a number in [%g, %g]", qPrintable(name), qPrintable(text), min, max);
+    if (pok != nullptr) *pok = false;
+    return fallback;
+}
+
+#endif //__COMMAND_LINE_H__
@@ -0,0 +1,20 @@
+#ifndef __FUNCTION_RUNNABLE_H__
+#define __FUNCTION_RUNNABLE_H__
+
+#include <QRunnable>
+#include <functional>
+
+/*
+ *  在 QThreadPool 中执行一个函数对象, 执行后由线程池删除
+ *  Qt 5.12 还没有 QRunnable::create()
+ */
+class FunctionRunnable : public QRunnable {
+public:
+    explicit FunctionRunnable(const std::function<void()> &function) : function_(function) {}
+    virtual void run() override { function_(); }
+
+private:
+    std::function<void()> function_;
+};
+
+#endif //__FUNCTION_RUNNABLE_H__
@@ -0,0 +1,100 @@
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ *  有界无锁环形队列, 一个生产者线程、一个消费者线程
+ *
+ *  每个槽带一个序号(Vyukov 有界队列的做法), 出队用 CAS 推进读位置,
+ *  因此生产者在队列满时也可以调用 try_pop() 丢弃最旧的数据, 不会与消费者冲突
+ *
+ *  约定: try_push() 只能由一个线程调用; try_pop() 最多由两个线程调用, 即消费者和生产者自身,
+ *  出队一侧实际是多消费者. 消费者已推进读位置但尚未释放槽时, 生产者的 try_push() 仍会失败,
+ *  生产者不应自旋等待
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(int capacity) {
+        size_t size = 2;
+        while (size < static_cast<size_t>(capacity)) size <<= 1;
+
+        mask_ = size - 1;
+        slots_ = new Slot[size];
+        for (size_t i = 0; i < size; i++) slots_[i].seq.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        high_water_.store(0, std::memory_order_relaxed);
+    }
+    ~SpscRing() { delete[] slots_; }
+
+    //生产者调用, 队列满时返回 false
+    bool try_push(const T &value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos) return false;
+
+        slot.value = value;
+        slot.seq.store(pos + 1, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_release);
+
+        //高水位只由生产者更新
+        size_t used = pos + 1 - tail_.load(std::memory_order_relaxed);
+        if (used > high_water_.load(std::memory_order_relaxed)) high_water_.store(used, std::memory_order_relaxed);
+        return true;
+    }
+
+    //消费者调用; 生产者也可调用以丢弃最旧的数据. 队列空时返回 false
+    bool try_pop(T *value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[pos & mask_];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+
+            if (diff == 0) {
+                //失败时 pos 被更新为最新的读位置
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    *value = slot.value;
+                    slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    int capacity() const { return static_cast<int>(mask_ + 1); }
+    //近似值, 仅用于统计
+    int size() const {
+        return static_cast<int>(head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed));
+    }
+    int high_water() const { return static_cast<int>(high_water_.load(std::memory_order_relaxed)); }
+
+private:
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    struct Slot {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    Slot *slots_;
+    size_t mask_;
+
+    //读写位置用填充隔开放在不同缓存行, 避免两个线程互相干扰
+    char pad0_[64];
+    std::atomic<size_t> head_;
+    std::atomic<size_t> high_water_;
+    char pad1_[64];
+    std::atomic<size_t> tail_;
+    char pad2_[64];
+};
+
+#endif //__SPSC_RING_H__
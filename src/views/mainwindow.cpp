@@ -1,8 +1,16 @@
 #include "mainwindow.h"
+
+#include <QActionGroup>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QInputDialog>
 //===================
 #include <qfiledialog.h>
 #include <qgsvectorlayer.h>
 #include <qgsapplication.h>
+#include <qgscoordinatereferencesystem.h>
 #include <qgsmaptoolpan.h>
 #include <qgsmaptoolzoom.h>
 #include <qgsrenderer.h>
@@ -11,9 +19,16 @@
 #include <qgsrasterlayer.h>
 #include <qgsproject.h>
 
+#include "src/map/raw_tile_cache.h"
+#include "src/map/tile_cache.h"
+#include "src/map/xyz_tile_provider.h"
+#include "src/utils/command_line.h"
+
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) { init_window(); }
 
 MainWindow::~MainWindow() {
+    stop_ingest();
+
     for (auto var : map_widgets_) {
         delete var;
     }
@@ -37,6 +52,8 @@ void MainWindow::closeEvent(QCloseEvent *e) {
     switch (QMessageBox::information(this, tr("提示"), tr("是否关闭？"), tr("确认"), tr("返回"), Q_NULLPTR, 1)) {
         case 0: {
             e->accept();
+            //exit() 不会析构窗口, 先收尾后台线程, 会话记录写完文件尾
+            stop_ingest();
             exit(0);
         }
         case 1:
@@ -54,12 +71,11 @@ void MainWindow::closeEvent(QCloseEvent *e) {
 bool MainWindow::eventFilter(QObject *o, QEvent *e) { return QWidget::eventFilter(o, e); }
 
 void MainWindow::slot_change_wid_statu(int type) {
-    auto var = map_widgets_[type];
-    bool statu = var->isVisible();
-
+    auto var = map_widgets_.value(type, Q_NULLPTR);
     if (var == Q_NULLPTR) return;
 
-    if (statu == true) {
+    //显示时各面板在 showEvent 中补入隐藏期间合并的数据并重建视图, 见 slot_panel_shown
+    if (var->isVisible()) {
         var->setVisible(false);
     } else {
         var->setVisible(true);
@@ -107,6 +123,8 @@ void MainWindow::init_window() {
     create_photoelectricity();
     create_description();
     create_firepower();
+    create_scheduler();
+    create_replay();
 
     //创建自定义标题栏
     create_title();
@@ -125,6 +143,8 @@ void MainWindow::init_window() {
 
     //添加数据
     create_data();
+    create_ingest();
+    pscheduler_->start();
 
     //默认隐藏所有窗体
     for (auto var : map_widgets_) {
@@ -142,13 +162,30 @@ void MainWindow::create_centwindow() {
 	map_canvas_->setAcceptDrops(true);
 	map_canvas_->setMouseTracking(true);
 	map_canvas_->setMapTool(new QgsMapToolPan(map_canvas_));
+	//底图为 Web 墨卡托瓦片, 画布使用同一坐标系, 绘制和预取都不需要重投影
+	map_canvas_->setDestinationCrs(QgsCoordinateReferenceSystem(QStringLiteral("EPSG:3857")));
 	//map_canvas_->setMinimumSize(QSize(1920, 1080));
 
-	QString fileName = "tmsforuser.xml";
-	QStringList temp = fileName.split('/');
-	QString basename = temp.at(temp.size() - 1);
+	//解码瓦片缓存: --tile-cache-mb <兆字节>(默认 256), 所有画布共用
+	QStringList args = QCoreApplication::arguments();
+	int cache_mb = arg_int(args, "--tile-cache-mb", 0, 1);
+	if (cache_mb > 0) TileCache::instance().set_budget(cache_mb * 1024LL * 1024);
+	//解码瓦片磁盘缓存: --tile-disk-cache <目录>, 默认关闭; --tile-disk-cache-mb <兆字节>(默认 1024), 0 不限制
+	QString disk_cache = arg_value(args, "--tile-disk-cache");
+	if (!disk_cache.isEmpty()) RawTileCache::instance().set_directory(disk_cache);
+	int disk_cache_mb = arg_int(args, "--tile-disk-cache-mb", -1, 0);
+	if (disk_cache_mb >= 0) RawTileCache::instance().set_budget(disk_cache_mb * 1024LL * 1024);
+
+	//底图: --tiles <瓦片归档或目录>; 默认在程序所在目录下优先读取打包的瓦片归档(tools/tile_packer 生成),
+	//没有时直接读取瓦片目录, 与启动时的工作目录无关
+	QString fileName = arg_value(args, "--tiles");
+	if (fileName.isEmpty()) {
+		QDir app_dir(QCoreApplication::applicationDirPath());
+		fileName = app_dir.filePath(app_dir.exists("Tiles.edta") ? "Tiles.edta" : "Tiles");
+	}
+	QString basename = QFileInfo(fileName).fileName();
 
-	QgsRasterLayer *rasterLayser = new QgsRasterLayer(fileName, basename, "gdal");
+	QgsRasterLayer *rasterLayser = new QgsRasterLayer(fileName, basename, XyzTileProvider::PROVIDER_KEY);
 
 	if (!rasterLayser->isValid())
 	{
@@ -156,6 +193,14 @@ void MainWindow::create_centwindow() {
 		return;
 	}
 
+	//底图瓦片预取: --tile-prefetch-mb <兆字节>(默认 32), 0 关闭
+	XyzTileProvider *provider = qobject_cast<XyzTileProvider *>(rasterLayser->dataProvider());
+	int prefetch_mb = arg_int(args, "--tile-prefetch-mb", -1, 0);
+	if (provider != nullptr && prefetch_mb != 0) {
+		pprefetcher_ = new TilePrefetcher(map_canvas_, provider->loader(), this);
+		if (prefetch_mb > 0) pprefetcher_->set_budget(prefetch_mb * 1024LL * 1024);
+	}
+
 	QgsProject::instance()->addMapLayer(rasterLayser);
 	//渲染线条;
 	map_canvas_->setExtent(rasterLayser->extent());//设置区域
@@ -184,6 +229,33 @@ void MainWindow::create_menubar() {
     QMenu *menu = menubar->addMenu(tr("文件"));
     map_menus_.insert(MENU_FILE, menu);
     QAction *action = menu->addAction(tr("打开文件"));
+    connect(action, &QAction::triggered, this, &MainWindow::slot_open_session);
+
+    //创建回放菜单项
+    menu = menubar->addMenu(tr("回放"));
+    map_menus_.insert(MENU_REPLAY, menu);
+    action = menu->addAction(tr("播放/暂停"));
+    connect(action, &QAction::triggered, [=] {
+        if (preplay_->is_playing())
+            preplay_->pause();
+        else
+            preplay_->play();
+    });
+    action = menu->addAction(tr("跳转..."));
+    connect(action, &QAction::triggered, this, &MainWindow::slot_seek_session);
+
+    QMenu *speed_menu = menu->addMenu(tr("回放速度"));
+    QActionGroup *speed_group = new QActionGroup(speed_menu);
+    for (int speed : {1, 2, 5, 10, 50, 100, 0}) {
+        action = speed_menu->addAction(speed > 0 ? tr("%1 倍").arg(speed) : tr("最快"));
+        action->setCheckable(true);
+        action->setChecked(speed == 1);
+        speed_group->addAction(action);
+        connect(action, &QAction::triggered, [=] { preplay_->set_speed(speed); });
+    }
+
+    action = menu->addAction(tr("返回实时"));
+    connect(action, &QAction::triggered, this, &MainWindow::slot_close_session);
 
     //创建视图菜单项
     menu = menubar->addMenu(tr("视图"));
@@ -200,6 +272,16 @@ void MainWindow::create_menubar() {
             emit var->sig_view(true);
         }
     });
+    //刷新频率
+    QMenu *rate_menu = menu->addMenu(tr("刷新频率"));
+    QActionGroup *rate_group = new QActionGroup(rate_menu);
+    for (int hz : {20, 30, 60}) {
+        action = rate_menu->addAction(tr("%1 Hz").arg(hz));
+        action->setCheckable(true);
+        action->setChecked(hz == pscheduler_->rate());
+        rate_group->addAction(action);
+        connect(action, &QAction::triggered, [=] { pscheduler_->set_rate(hz); });
+    }
     menu->addSection("on_off");
 
     action_overlaping_ = menu->addAction(tr("重叠"));
@@ -256,10 +338,41 @@ void MainWindow::create_status_bar() {
 
     QLabel *l = new QLabel(simu_start_time_, pstatus_bar_);
     pstatus_bar_->addWidget(l);
+    list_labels_.push_back(l);
     l = new QLabel(simu_end_time_, pstatus_bar_);
     pstatus_bar_->addWidget(l);
+    list_labels_.push_back(l);
     l = new QLabel(curr_reality_time_, pstatus_bar_);
     pstatus_bar_->addWidget(l);
+    list_labels_.push_back(l);
+
+    prefresh_label_ = new QLabel(pstatus_bar_);
+    pstatus_bar_->addPermanentWidget(prefresh_label_);
+    connect(pscheduler_, &RefreshScheduler::sig_stats, this, [=](const RefreshStats &stats) {
+        QString text = tr("刷新 %1Hz 面板 %2 平均 %3ms 最大 %4ms")
+                           .arg(stats.ticks)
+                           .arg(stats.panels)
+                           .arg(stats.avg_ms, 0, 'f', 2)
+                           .arg(stats.max_ms, 0, 'f', 2);
+        if (stats.unknown_codes > 0) text += tr(" 未知代码 %1").arg(stats.unknown_codes);
+        if (preceiver_ != nullptr) {
+            RingStats ring = preceiver_->ring_stats();
+            text += tr(" 队列峰值 %1/%2 丢弃 %3 坏帧 %4")
+                        .arg(ring.high_water)
+                        .arg(ring.capacity)
+                        .arg(ring.dropped)
+                        .arg(preceiver_->rejected_frames());
+        }
+        //磁盘慢时待写缓冲区增长, 峰值持续上升说明写盘跟不上, 到上限后开始丢弃
+        if (precorder_ != nullptr) {
+            text += tr(" 记录 %1 条 %2MB 待写峰值 %3")
+                        .arg(precorder_->recorded_records())
+                        .arg(precorder_->bytes_written() / (1024.0 * 1024), 0, 'f', 1)
+                        .arg(precorder_->pending_high_water());
+            if (precorder_->dropped_records() > 0) text += tr(" 未记录 %1").arg(precorder_->dropped_records());
+        }
+        prefresh_label_->setText(text);
+    });
 
     playout_->addWidget(pstatus_bar_);
 }
@@ -421,6 +534,7 @@ void MainWindow::create_description() {
     sub_w->set_title_visib(false);
     sub_w->set_view(view);
     sub_w->set_model(model, GBI_RESOURCES, HORIZONTAL_HEAD);
+    attach_live_proxy(sub_w);
     vblayout->addWidget(sub_w);
     w->add_sub_widget(sub_w);
     map_widgets_.insert(GBI_RESOURCES, sub_w);
@@ -463,11 +577,15 @@ void MainWindow::create_firepower() {
     Widget *sub_w = nullptr;
     //创建火力单元通道状态
     sub_w = new Widget(tr("火力单元通道状态"));
-    model = new TableModel();
+    model = new KeyedTableModel();
     view = create_tablewindow(model, false, true);
+    //通道可达上万行, 固定行高, 视图不再逐行测量
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(24);
     sub_w->set_title_visib(false);
     sub_w->set_view(view);
     sub_w->set_model(model, FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+    attach_live_proxy(sub_w);
     vblayout->addWidget(sub_w);
     w->add_sub_widget(sub_w);
     map_widgets_.insert(FIREPOWER_UNIT_AISLE, sub_w);
@@ -475,6 +593,46 @@ void MainWindow::create_firepower() {
     w->show();
 }
 
+void MainWindow::attach_live_proxy(Widget *w) {
+    //点击表头排序, 右键表头按枚举状态过滤
+    TableModel *model = w->get_model();
+    QTableView *view = w->get_view();
+    LiveProxyModel *proxy = new LiveProxyModel(view);
+    proxy->setSourceModel(model);
+    view->setModel(proxy);
+    view->setSortingEnabled(true);
+
+    QHeaderView *header = view->horizontalHeader();
+    header->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(header, &QHeaderView::customContextMenuRequested, [=](const QPoint &pos) {
+        int column = header->logicalIndexAt(pos);
+        QStringList texts = model->field_label_texts(column);
+        if (texts.isEmpty()) return;
+
+        QStringList current = (proxy->filter_column() == column) ? proxy->filter_texts() : QStringList();
+        QMenu menu;
+        QAction *all = menu.addAction(tr("全部"));
+        menu.addSeparator();
+        for (auto var : texts) {
+            QAction *action = menu.addAction(var);
+            action->setCheckable(true);
+            action->setChecked(current.contains(var));
+        }
+
+        QAction *action = menu.exec(header->mapToGlobal(pos));
+        if (action == nullptr) return;
+        if (action == all) {
+            proxy->set_filter(column, QStringList());
+            return;
+        }
+        if (action->isChecked())
+            current << action->text();
+        else
+            current.removeAll(action->text());
+        proxy->set_filter(column, current);
+    });
+}
+
 void MainWindow::create_data() {
     TableModel *model = Q_NULLPTR;
 
@@ -594,9 +752,214 @@ void MainWindow::create_data() {
     model = map_widgets_[FIREPOWER_UNIT_AISLE]->get_model();
     model->add_data(fir_ais, FIREPOWER_UNIT_AISLE);
 
+    //初始数据由刷新调度在面板显示后的第一帧通知视图
+}
+
+void MainWindow::create_scheduler() {
+    //刷新频率: --refresh-hz <频率>(默认 30)
+    int hz = arg_int(QCoreApplication::arguments(), "--refresh-hz", 0, 1, 120);
+
+    pscheduler_ = new RefreshScheduler(this);
+    if (hz > 0) pscheduler_->set_rate(hz);
+    for (auto var : map_widgets_) {
+        pscheduler_->add_panel(var);
+        connect(var, &Widget::sig_shown, this, &MainWindow::slot_panel_shown);
+    }
+    connect(pscheduler_, &RefreshScheduler::sig_tick, this, &MainWindow::slot_apply_records);
+}
+
+void MainWindow::create_ingest() {
+    qRegisterMetaType<ElementRecord>("ElementRecord");
+    qRegisterMetaType<QVector<ElementRecord>>("QVector<ElementRecord>");
+
+    //队列: --ring-size <条数>(默认 16384), --overflow oldest|latest 队列满时丢弃最旧记录或按主键保留最新值
+    QStringList args = QCoreApplication::arguments();
+    preceiver_ = new TelemetryReceiver(arg_int(args, "--ring-size", 16384, 1, 1 << 24));
+    if (arg_value(args, "--overflow") == "oldest") preceiver_->set_overflow_policy(OVERFLOW_DROP_OLDEST);
+
+    //数据源: --frame-file <文件> [间隔毫秒] 按帧回放文件, 否则监听 --udp-port <端口>(默认 6000)
+    QString frame_file = arg_value(args, "--frame-file");
+    if (!frame_file.isEmpty()) {
+        bool ok = false;
+        int interval = arg_value(args, "--frame-file", 2).toInt(&ok);
+        preceiver_->set_file_source(frame_file, (ok && interval > 0) ? interval : 10);
+    } else {
+        quint16 port = static_cast<quint16>(arg_int(args, "--udp-port", 6000, 1, 65535));
+        preceiver_->set_udp_source(QHostAddress::AnyIPv4, port);
+    }
+
+    //追加模式的表格每条记录都要显示, 不做合并
+    for (auto it = map_widgets_.begin(); it != map_widgets_.end(); ++it) {
+        TableModel *model = it.value()->get_model();
+        if (model != nullptr) conflator_.set_conflated(it.key(), model->insert_mode() == UPSERT_MODE);
+    }
+
+    //会话记录: --record <文件>
+    QString record_file = arg_value(args, "--record");
+    if (!record_file.isEmpty()) create_recorder(record_file);
+
+    pingest_thread_ = new QThread(this);
+    preceiver_->moveToThread(pingest_thread_);
+    connect(pingest_thread_, &QThread::started, preceiver_, &TelemetryReceiver::start);
+    connect(pingest_thread_, &QThread::finished, preceiver_, &QObject::deleteLater);
+    connect(preceiver_, &TelemetryReceiver::sig_ready, this, &MainWindow::slot_ready, Qt::QueuedConnection);
+    connect(preceiver_, &TelemetryReceiver::sig_error, this,
+            [=](const QString &message) { pstatus_bar_->showMessage(message, 5000); }, Qt::QueuedConnection);
+    pingest_thread_->start();
+}
+
+void MainWindow::create_recorder(const QString &path) {
+    precorder_ = new SessionRecorder();
+    QString error;
+    if (!precorder_->open(path, &error)) {
+        pstatus_bar_->showMessage(tr("无法创建会话记录 %1: %2").arg(path).arg(error), 5000);
+        delete precorder_;
+        precorder_ = nullptr;
+        return;
+    }
+
+    precord_thread_ = new QThread(this);
+    precorder_->moveToThread(precord_thread_);
+    connect(precord_thread_, &QThread::started, precorder_, &SessionRecorder::start);
+    connect(precord_thread_, &QThread::finished, precorder_, &QObject::deleteLater);
+    connect(precorder_, &SessionRecorder::sig_error, this,
+            [=](const QString &message) { pstatus_bar_->showMessage(message, 5000); }, Qt::QueuedConnection);
+    precord_thread_->start();
+
+    preceiver_->set_recorder(precorder_);
+}
+
+void MainWindow::stop_ingest() {
+    //先停止解码, 之后不再有新记录, 再让记录器写完剩余数据和文件尾
+    if (pingest_thread_ != nullptr && pingest_thread_->isRunning()) {
+        pingest_thread_->quit();
+        pingest_thread_->wait();
+    }
+    if (precord_thread_ != nullptr && precord_thread_->isRunning()) {
+        QMetaObject::invokeMethod(precorder_, "close", Qt::BlockingQueuedConnection);
+        precord_thread_->quit();
+        precord_thread_->wait();
+    }
+}
+
+void MainWindow::create_replay() {
+    preplay_ = new ReplayEngine(this);
+
+    //回放数据与实时数据走同一条合并和刷新路径, 打开和跳转时先清空面板再接收完整状态
+    connect(preplay_, &ReplayEngine::sig_reset, this, &MainWindow::clear_models);
+    connect(preplay_, &ReplayEngine::sig_records, this, [=](const QVector<ElementRecord> &records) {
+        conflator_.add(records);
+    });
+    connect(preplay_, &ReplayEngine::sig_position, this, [=](qint64 timestamp) {
+        list_labels_.at(LABEL_CURR_TIME)->setText(curr_reality_time_ + session_time_text(timestamp));
+    });
+    connect(preplay_, &ReplayEngine::sig_finished, this,
+            [=] { pstatus_bar_->showMessage(tr("回放结束"), 5000); });
+    //损坏的块已跳过, 回放继续
+    connect(preplay_, &ReplayEngine::sig_error, this,
+            [=](const QString &message) { pstatus_bar_->showMessage(message, 5000); });
+}
+
+QString MainWindow::session_time_text(qint64 timestamp) const {
+    return QDateTime::fromMSecsSinceEpoch(preplay_->start_time() + timestamp).toString("yyyy-MM-dd hh:mm:ss.zzz");
+}
+
+void MainWindow::clear_models() {
+    conflator_.clear();
     for (auto var : map_widgets_) {
-        var->update();
         TableModel *model = var->get_model();
-        if (model != nullptr) model->update();
+        if (model != nullptr) model->clear_data();
+    }
+}
+
+void MainWindow::slot_open_session() {
+    QString path = QFileDialog::getOpenFileName(this, tr("打开会话记录"), QString(),
+                                                tr("会话记录 (*.edcs);;所有文件 (*)"));
+    if (path.isEmpty()) return;
+
+    //打开前会关闭当前回放, 失败时面板中不能留下上一个会话的内容
+    bool replaying = preplay_->is_open();
+    QString error;
+    if (!preplay_->open(path, &error)) {
+        if (replaying) {
+            clear_models();
+            reset_session_labels();
+        }
+        QMessageBox::warning(this, tr("提示"), tr("无法打开 %1: %2").arg(path).arg(error));
+        return;
+    }
+
+    //回放期间丢弃实时数据, 面板只显示回放内容(打开时已通过 sig_reset 清空)
+    list_labels_.at(LABEL_START_TIME)->setText(simu_start_time_ + session_time_text(preplay_->first_timestamp()));
+    list_labels_.at(LABEL_END_TIME)->setText(simu_end_time_ + session_time_text(preplay_->last_timestamp()));
+    preplay_->play();
+}
+
+void MainWindow::slot_seek_session() {
+    if (!preplay_->is_open()) return;
+
+    //按距开始的秒数跳转
+    double length = (preplay_->last_timestamp() - preplay_->first_timestamp()) / 1000.0;
+    double current = (preplay_->position() - preplay_->first_timestamp()) / 1000.0;
+    bool ok = false;
+    double seconds = QInputDialog::getDouble(this, tr("跳转"), tr("距开始的秒数(0 - %1):").arg(length, 0, 'f', 1),
+                                             current, 0.0, length, 1, &ok);
+    if (!ok) return;
+
+    preplay_->seek(preplay_->first_timestamp() + static_cast<qint64>(seconds * 1000.0));
+}
+
+void MainWindow::slot_close_session() {
+    if (!preplay_->is_open()) return;
+
+    preplay_->close();
+    clear_models();
+    reset_session_labels();
+}
+
+void MainWindow::reset_session_labels() {
+    list_labels_.at(LABEL_START_TIME)->setText(simu_start_time_);
+    list_labels_.at(LABEL_END_TIME)->setText(simu_end_time_);
+    list_labels_.at(LABEL_CURR_TIME)->setText(curr_reality_time_);
+}
+
+void MainWindow::slot_ready() {
+    //取走队列中的全部记录, 缓冲区重复使用
+    ring_records_.resize(0);
+    if (preceiver_->take_records(&ring_records_) == 0) return;
+    if (preplay_->is_open()) return;
+
+    conflator_.add(ring_records_);
+}
+
+void MainWindow::slot_apply_records() {
+    //合并后的记录每帧写入一次模型, 帧内同一装备的多次更新只处理最后一次
+    //隐藏面板的数据留在合并器中, 每个装备只占一条最新值
+    ring_records_.resize(0);
+    for (auto it = map_widgets_.constBegin(); it != map_widgets_.constEnd(); ++it) {
+        if (it.value()->isVisible()) conflator_.take(it.key(), &ring_records_);
+    }
+    if (!ring_records_.isEmpty()) slot_records(ring_records_);
+}
+
+void MainWindow::slot_panel_shown(int type) {
+    //模型仍处于停放状态, 写入后由 set_parked(false) 一次性重建视图
+    ring_records_.resize(0);
+    if (conflator_.take(type, &ring_records_) > 0) slot_records(ring_records_);
+}
+
+void MainWindow::slot_records(const QVector<ElementRecord> &records) {
+    //同类型的连续记录一次写入对应模型, 视图由刷新调度统一通知
+    int i = 0;
+    while (i < records.size()) {
+        int type = records.at(i).type;
+        int first = i;
+        while (i < records.size() && records.at(i).type == type) i++;
+
+        Widget *w = map_widgets_.value(type, Q_NULLPTR);
+        TableModel *model = (w != Q_NULLPTR) ? w->get_model() : Q_NULLPTR;
+        if (model == Q_NULLPTR) continue;
+
+        model->add_records(records.constData() + first, i - first);
     }
 }
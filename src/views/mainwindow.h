@@ -13,18 +13,34 @@
 #include <QPropertyAnimation>
 #include <QStatusBar>
 #include <QTableWidget>
+#include <QThread>
 #include <QVBoxLayout>
 
 #include<qgsmapcanvas.h>
 
+#include "src/io/replay_engine.h"
+#include "src/io/telemetry_receiver.h"
+#include "src/map/tile_prefetcher.h"
+#include "src/models/keyed_tablemodel.h"
+#include "src/models/live_proxy_model.h"
+#include "src/models/record_conflator.h"
 #include "src/models/tablemodel.h"
 #include "src/utils/macro.h"
+#include "src/views/refresh_scheduler.h"
 #include "src/views/widget.h"
 #include "titlebar.h"
 
 enum Menus {
     MENU_FILE = 0,
     MENU_VIEW,
+    MENU_REPLAY,
+};
+
+//状态栏时间标签在 list_labels_ 中的下标
+enum StatusLabels {
+    LABEL_START_TIME = 0,
+    LABEL_END_TIME,
+    LABEL_CURR_TIME,
 };
 
 class MainWindow : public QMainWindow {
@@ -44,6 +60,13 @@ signals:
 public slots:
     void slot_change_wid_statu(int type);
     void from_arranged(QAction *action);
+    void slot_ready();
+    void slot_apply_records();
+    void slot_panel_shown(int type);
+    void slot_open_session();
+    void slot_seek_session();
+    void slot_close_session(); //结束回放, 返回实时数据
+    void slot_records(const QVector<ElementRecord> &records);
 
 private:
     void init_window();
@@ -65,6 +88,15 @@ private:
     void create_firepower();
 
     void create_data();
+    void create_ingest(); //创建遥测接收线程
+    void create_recorder(const QString &path); //创建会话记录线程
+    void stop_ingest();
+    void create_replay();
+    void clear_models();
+    void reset_session_labels();
+    QString session_time_text(qint64 timestamp) const;
+    void create_scheduler(); //创建面板刷新调度
+    void attach_live_proxy(Widget *w); //表格增加排序和过滤
 private:
     QWidget *pcentral_window_;
     QVBoxLayout *playout_;
@@ -86,10 +118,21 @@ private:
     QAction *action_horizontal_;
     QAction *action_vertical_;
 	
+    QThread *pingest_thread_ = nullptr;
+    TelemetryReceiver *preceiver_ = nullptr;
+    QThread *precord_thread_ = nullptr;
+    SessionRecorder *precorder_ = nullptr;
+    ReplayEngine *preplay_ = nullptr;
+    QVector<ElementRecord> ring_records_; //从接收队列取出的记录
+    RecordConflator conflator_;
+    RefreshScheduler *pscheduler_ = nullptr;
+    QLabel *prefresh_label_ = nullptr;
+
 	//======================================
 	QWidget *qgis_w_ = nullptr;
 	QList<QgsMapLayer *> layers_;
 	QgsMapCanvas *map_canvas_;
+	TilePrefetcher *pprefetcher_ = nullptr;
 };
 
 #endif // MAINWINDOW_H
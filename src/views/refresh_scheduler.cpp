@@ -0,0 +1,92 @@
+#include "refresh_scheduler.h"
+
+#include "widget.h"
+
+RefreshScheduler::RefreshScheduler(QObject *parent) : QObject(parent) {
+    //单次定时, 每帧按累计时间重新计算间隔, 整数毫秒间隔不会使实际频率偏离设定值
+    timer_.setTimerType(Qt::PreciseTimer);
+    timer_.setSingleShot(true);
+    connect(&timer_, &QTimer::timeout, this, &RefreshScheduler::on_tick);
+}
+
+void RefreshScheduler::set_rate(int hz) {
+    rate_ = qBound(1, hz, 120);
+    if (!running_) return;
+    restart_pacing();
+    schedule_next();
+}
+
+void RefreshScheduler::start() {
+    running_ = true;
+    stats_clock_.start();
+    restart_pacing();
+    schedule_next();
+}
+
+void RefreshScheduler::stop() {
+    running_ = false;
+    timer_.stop();
+}
+
+void RefreshScheduler::restart_pacing() {
+    pace_clock_.start();
+    frames_ = 0;
+}
+
+void RefreshScheduler::schedule_next() {
+    //第 n 帧在 n * 1000 / rate_ 毫秒时到期; 落后超过一帧时不追赶, 从当前时刻重新计时
+    frames_++;
+    qint64 due = qRound64(frames_ * 1000.0 / rate_);
+    qint64 wait = due - pace_clock_.elapsed();
+    if (wait < -1000 / rate_) {
+        restart_pacing();
+        frames_ = 1;
+        wait = qRound64(1000.0 / rate_);
+    }
+    timer_.start(static_cast<int>(qMax<qint64>(0, wait)));
+}
+
+void RefreshScheduler::on_tick() {
+    tick_clock_.start();
+
+    // 1.写入本帧数据
+    emit sig_tick();
+
+    // 2.只刷新可见且有变化的面板
+    for (auto var : list_panels_) {
+        if (!var->isVisible()) continue;
+
+        TableModel *model = var->get_model();
+        if (model == nullptr || !model->has_pending()) continue;
+        model->update();
+        panels_++;
+    }
+
+    qint64 ns = tick_clock_.nsecsElapsed();
+    total_ns_ += ns;
+    max_ns_ = qMax(max_ns_, ns);
+    ticks_++;
+
+    // 3.每秒汇总一次
+    if (stats_clock_.elapsed() >= 1000) {
+        RefreshStats stats;
+        stats.rate = rate_;
+        stats.ticks = ticks_;
+        stats.panels = panels_;
+        stats.avg_ms = total_ns_ / 1e6 / ticks_;
+        stats.max_ms = max_ns_ / 1e6;
+        stats.unknown_codes = 0;
+        for (auto var : list_panels_) {
+            if (var->get_model() != nullptr) stats.unknown_codes += var->get_model()->unknown_codes();
+        }
+        emit sig_stats(stats);
+
+        ticks_ = 0;
+        panels_ = 0;
+        total_ns_ = 0;
+        max_ns_ = 0;
+        stats_clock_.restart();
+    }
+
+    if (running_) schedule_next();
+}
@@ -0,0 +1,66 @@
+#ifndef __REFRESH_SCHEDULER_H__
+#define __REFRESH_SCHEDULER_H__
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+class Widget;
+
+//刷新耗时统计, 每秒汇总一次
+struct RefreshStats {
+    int rate;          //设定频率, Hz
+    int ticks;         //统计周期内的刷新次数
+    int panels;        //统计周期内实际刷新的面板数
+    double avg_ms;     //每次刷新平均耗时
+    double max_ms;     //每次刷新最大耗时
+    quint64 unknown_codes; //各面板累计收到的未知枚举代码数
+};
+
+/*
+ *  统一按固定频率刷新所有浮动面板
+ *  每次定时先发出 sig_tick 由外部把待处理数据写入模型, 再对可见且有变化的面板调用
+ *  TableModel::update() 一次性通知视图; 隐藏的面板不刷新, 变化保留到重新显示后的下一帧
+ */
+class RefreshScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RefreshScheduler(QObject *parent = nullptr);
+
+    void add_panel(Widget *w) { list_panels_.append(w); }
+    void set_rate(int hz);
+    int rate() const { return rate_; }
+
+    void start();
+    void stop();
+
+signals:
+    void sig_tick();
+    void sig_stats(const RefreshStats &stats);
+
+private slots:
+    void on_tick();
+
+private:
+    void restart_pacing();
+    void schedule_next();
+
+private:
+    QTimer timer_;
+    int rate_ = 30;
+    bool running_ = false;
+    QElapsedTimer pace_clock_; //按帧序号计算到期时间
+    qint64 frames_ = 0;
+    QList<Widget *> list_panels_;
+
+    QElapsedTimer tick_clock_;  //单次刷新耗时
+    QElapsedTimer stats_clock_; //统计周期
+    int ticks_ = 0;
+    int panels_ = 0;
+    qint64 total_ns_ = 0;
+    qint64 max_ns_ = 0;
+};
+
+#endif //__REFRESH_SCHEDULER_H__
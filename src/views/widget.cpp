@@ -38,6 +38,8 @@ void Widget::set_model(TableModel *model, ElementType type, HeadLocal local) {
         in_view_->setModel(model);
         in_model_ = model;
         model->set_head_data(type, local);
+        //未显示的面板只保存数据
+        model->set_parked(!isVisible());
     }
     widget_type_ = type;
 }
@@ -57,6 +59,20 @@ void Widget::closeEvent(QCloseEvent *e) {
     Q_UNUSED(e)
 }
 
+void Widget::showEvent(QShowEvent *e) {
+    //先补入隐藏期间的数据, 再整体重建视图
+    emit sig_shown(widget_type_);
+    if (in_model_ != nullptr) in_model_->set_parked(false);
+
+    QWidget::showEvent(e);
+}
+
+void Widget::hideEvent(QHideEvent *e) {
+    if (in_model_ != nullptr) in_model_->set_parked(true);
+
+    QWidget::hideEvent(e);
+}
+
 bool Widget::eventFilter(QObject *o, QEvent *e) {
     if (o == pselect_list_ && e->type() == QEvent::Close) {
         QWidget *w = qobject_cast<QWidget *>(o);
@@ -88,7 +104,7 @@ void Widget::create_select_list() {
     pselect_list_ = new QWidget();
     QVBoxLayout *layout = new QVBoxLayout(pselect_list_);
     QListWidget *list_w = new QListWidget(pselect_list_);
-    QStringList *string_list = in_model_->get_row_name(widget_type_);
+    const QStringList *string_list = in_model_->get_row_name(widget_type_);
 
     // 0.添加筛选功能和全选/全不选
     QHBoxLayout *hbl = new QHBoxLayout(pselect_list_);
@@ -197,12 +213,15 @@ bool Widget::load_style_sheet(const QString &path) {
 }
 
 void Widget::on_setting_visible() {
+    //垂直表头时字段为行, 水平表头时字段为列
+    bool vertical = (in_model_->head_local() == VERTICAL_HEAD);
     for (int i = 0; i < list_head_checkbox_.size(); i++) {
-        if (list_head_checkbox_[i]->checkState() == Qt::CheckState::Checked) {
-            in_view_->setRowHidden(i, false);
-        } else {
-            in_view_->setRowHidden(i, true);
-        }
+        bool checked = (list_head_checkbox_[i]->checkState() == Qt::CheckState::Checked);
+        if (vertical)
+            in_view_->setRowHidden(i, !checked);
+        else
+            in_view_->setColumnHidden(i, !checked);
+        in_model_->set_field_visible(i, checked);
     }
 
     for (int i = 0; i < list_widget_checkbox_.size(); i++) {
@@ -5,11 +5,13 @@
 #include <QCheckBox>
 #include <QCloseEvent>
 #include <QEvent>
+#include <QHideEvent>
 #include <QFile>
 #include <QHeaderView>
 #include <QListWidget>
 #include <QListWidgetItem>
 #include <QPushButton>
+#include <QShowEvent>
 #include <QTableView>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -38,6 +40,8 @@ public:
 
 protected:
     virtual void closeEvent(QCloseEvent *e) override;
+    virtual void showEvent(QShowEvent *e) override;
+    virtual void hideEvent(QHideEvent *e) override;
     virtual bool eventFilter(QObject *o, QEvent *e) override;
 
 private slots:
@@ -48,6 +52,7 @@ private slots:
 signals:
     void sig_close(bool);
     void sig_view(bool);
+    void sig_shown(int type); //面板即将显示, 模型恢复通知前发出
 
 public slots:
     bool load_style_sheet(const QString &path);
@@ -64,8 +69,8 @@ private:
     QWidget *pselect_list_;
     FramelessHelper *phelper_;
 
-    TableModel *in_model_;
-    QTableView *in_view_;
+    TableModel *in_model_ = nullptr;
+    QTableView *in_view_ = nullptr;
     QPushButton *in_select_;
 
     QList<Widget *> list_sub_widgets_;
@@ -0,0 +1,28 @@
+#ifndef __TEST_RECORDS_H__
+#define __TEST_RECORDS_H__
+
+#include <cstring>
+
+#include "src/models/element_record.h"
+
+//构造测试用的工作频点记录, 主键为 id
+inline ElementRecord make_frequency(int id, double frequency, qint64 timestamp = 0) {
+    WorkFrequency data;
+    data.id = id;
+    data.frequency_point = frequency;
+
+    ElementRecord record;
+    std::memset(&record, 0, sizeof(record));
+    pack_element(*element_descriptor(WORK_FREQUENCY), &data, &record);
+    record.timestamp = timestamp;
+    return record;
+}
+
+//取工作频点记录中的频点
+inline double frequency_of(const ElementRecord &record) {
+    double value;
+    std::memcpy(&value, record.payload + sizeof(qint32), sizeof(value));
+    return value;
+}
+
+#endif //__TEST_RECORDS_H__
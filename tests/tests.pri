@@ -0,0 +1,15 @@
+# 各测试共用的设置, 被测代码直接从 src 编译
+
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+ROOT = $$PWD/..
+INCLUDEPATH += $${ROOT} $$PWD
+
+HEADERS += \
+    $$PWD/test_records.h
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# 单元测试, 每个子目录是一个 QTest 程序, make check 运行全部
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_keyed_tablemodel \
+    tst_live_proxy_model \
+    tst_session_replay \
+    tst_spsc_ring \
+    tst_tablemodel \
+    tst_telemetry_codec \
+    tst_telemetry_receiver
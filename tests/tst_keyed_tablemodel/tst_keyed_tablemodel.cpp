@@ -0,0 +1,163 @@
+#include <QAbstractItemModelTester>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QSignalSpy>
+#include <QtTest>
+#include <algorithm>
+#include <random>
+
+#include "src/models/keyed_tablemodel.h"
+
+typedef QPair<int, int> Key;
+
+class TstKeyedTableModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void signed_key_order();
+    void mixed_batch();
+    void remove_before_shown();
+    void batch_within_frame_budget();
+
+private:
+    static void upsert(KeyedTableModel *pmodel, const Key &key, int status);
+    static void remove(KeyedTableModel *pmodel, const Key &key);
+    static QList<Key> keys(const KeyedTableModel &model);
+};
+
+void TstKeyedTableModel::upsert(KeyedTableModel *pmodel, const Key &key, int status) {
+    FirepowerUnitAisle data;
+    data.unit_id = key.first;
+    data.target_id = key.second;
+    data.status = status;
+    pmodel->add_data(data);
+}
+
+void TstKeyedTableModel::remove(KeyedTableModel *pmodel, const Key &key) {
+    FirepowerUnitAisle data;
+    data.unit_id = key.first;
+    data.target_id = key.second;
+    data.status = 0;
+    pmodel->remove_data(&data, FIREPOWER_UNIT_AISLE);
+}
+
+QList<Key> TstKeyedTableModel::keys(const KeyedTableModel &model) {
+    QList<Key> list;
+    for (int row = 0; row < model.rowCount(); row++) {
+        list << Key(model.index(row, 0).data(RAW_VALUE_ROLE).toInt(), model.index(row, 1).data(RAW_VALUE_ROLE).toInt());
+    }
+    return list;
+}
+
+void TstKeyedTableModel::signed_key_order() {
+    KeyedTableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.set_head_data(FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+
+    //负编号排在正编号之前, 两个字段都按有符号值比较
+    QList<Key> list({Key(1, -1), Key(-1, 5), Key(0, 0), Key(1, 2), Key(-2, -3), Key(-1, -5)});
+    for (const Key &key : list) upsert(&model, key, 1);
+    model.update();
+
+    std::sort(list.begin(), list.end());
+    QCOMPARE(keys(model), list);
+
+    upsert(&model, Key(0, -7), 1);
+    upsert(&model, Key(-3, 0), 1);
+    model.update();
+    list << Key(0, -7) << Key(-3, 0);
+    std::sort(list.begin(), list.end());
+    QCOMPARE(keys(model), list);
+}
+
+void TstKeyedTableModel::mixed_batch() {
+    KeyedTableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.set_head_data(FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+    for (int i = 0; i < 10; i++) upsert(&model, Key(i * 10, 0), 1);
+    model.update();
+
+    //同一批次: 头部、中间、尾部删除, 多个位置插入, 更新
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    remove(&model, Key(0, 0));
+    remove(&model, Key(40, 0));
+    remove(&model, Key(50, 0));
+    remove(&model, Key(90, 0));
+    upsert(&model, Key(-5, 0), 2);
+    upsert(&model, Key(45, 0), 2);
+    upsert(&model, Key(46, 0), 2);
+    upsert(&model, Key(95, 0), 2);
+    upsert(&model, Key(50, 0), 2);
+    upsert(&model, Key(20, 0), 3);
+    model.update();
+
+    QCOMPARE(keys(model), QList<Key>({Key(-5, 0), Key(10, 0), Key(20, 0), Key(30, 0), Key(45, 0), Key(46, 0),
+                                      Key(50, 0), Key(60, 0), Key(70, 0), Key(80, 0), Key(95, 0)}));
+    QCOMPARE(removed.count(), 3);
+    QCOMPARE(inserted.count(), 3);
+    QCOMPARE(model.index(2, 2).data(RAW_VALUE_ROLE).toInt(), 3);
+    QCOMPARE(model.index(6, 2).data(RAW_VALUE_ROLE).toInt(), 2);
+    QVERIFY(!model.has_pending());
+}
+
+void TstKeyedTableModel::remove_before_shown() {
+    KeyedTableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.set_head_data(FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+    upsert(&model, Key(1, 0), 1);
+    model.update();
+
+    //未显示就删除的记录不通知, 槽位在同一批次中被复用
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    upsert(&model, Key(2, 0), 1);
+    remove(&model, Key(2, 0));
+    QVERIFY(!model.has_pending());
+    upsert(&model, Key(3, 0), 1);
+    upsert(&model, Key(2, 0), 4);
+    model.update();
+
+    QCOMPARE(keys(model), QList<Key>({Key(1, 0), Key(2, 0), Key(3, 0)}));
+    QCOMPARE(model.index(1, 2).data(RAW_VALUE_ROLE).toInt(), 4);
+    QCOMPARE(inserted.count(), 1);
+}
+
+void TstKeyedTableModel::batch_within_frame_budget() {
+    //默认刷新频率 30Hz, 一个批次的写入和通知不超过一帧
+    const qint64 frame_ms = 33;
+    const int count = 10000;
+
+    KeyedTableModel model;
+    model.set_head_data(FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+    QVector<Key> shown;
+    for (int i = 0; i < count; i++) shown << Key(i / 100 - 50, i % 100);
+    for (const Key &key : shown) upsert(&model, key, 1);
+    model.update();
+    QCOMPARE(model.rowCount(), count);
+
+    //一万次操作: 一半原地更新, 四分之一分散删除, 四分之一新主键分散插入
+    std::mt19937 random(20260101);
+    std::shuffle(shown.begin(), shown.end(), random);
+    QVector<Key> added;
+    for (int i = 0; i < count / 4; i++) added << Key(int(random() % 200) - 100, 100 + i);
+
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count / 2; i++) upsert(&model, shown.at(i), 2);
+    for (int i = count / 2; i < count * 3 / 4; i++) remove(&model, shown.at(i));
+    for (const Key &key : added) upsert(&model, key, 3);
+    model.update();
+    qint64 elapsed = timer.elapsed();
+
+    QVERIFY2(elapsed <= frame_ms, qPrintable(QString("batch took %1 ms").arg(elapsed)));
+    QVERIFY(removed.count() > 1);
+    QCOMPARE(model.rowCount(), count);
+
+    QList<Key> list = keys(model);
+    QVERIFY(std::is_sorted(list.begin(), list.end()));
+    QVERIFY(std::adjacent_find(list.begin(), list.end()) == list.end());
+}
+
+QTEST_MAIN(TstKeyedTableModel)
+#include "tst_keyed_tablemodel.moc"
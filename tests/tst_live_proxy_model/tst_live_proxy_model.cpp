@@ -0,0 +1,175 @@
+#include <QAbstractItemModelTester>
+#include <QtTest>
+
+#include "src/models/keyed_tablemodel.h"
+#include "src/models/live_proxy_model.h"
+
+class TstLiveProxyModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void sort_follows_updates();
+    void hidden_sort_column();
+    void hidden_filter_column();
+    void source_removals();
+    void keyed_source_inserts();
+
+private:
+    static void set_frequency(TableModel *pmodel, int id, double frequency);
+    static void set_radiation(TableModel *pmodel, int id, int state);
+    static void remove(TableModel *pmodel, int id);
+    //代理中按显示顺序的第 0 列原始值
+    static QList<int> ids(const LiveProxyModel &proxy);
+};
+
+void TstLiveProxyModel::set_frequency(TableModel *pmodel, int id, double frequency) {
+    WorkFrequency data;
+    data.id = id;
+    data.frequency_point = frequency;
+    pmodel->add_data(data);
+}
+
+void TstLiveProxyModel::set_radiation(TableModel *pmodel, int id, int state) {
+    RadiationState data;
+    data.equipment_id = id;
+    data.radiation_state = state;
+    pmodel->add_data(data);
+}
+
+void TstLiveProxyModel::remove(TableModel *pmodel, int id) {
+    WorkFrequency data;
+    data.id = id;
+    data.frequency_point = 0;
+    pmodel->remove_data(&data, WORK_FREQUENCY);
+}
+
+QList<int> TstLiveProxyModel::ids(const LiveProxyModel &proxy) {
+    QList<int> list;
+    for (int row = 0; row < proxy.rowCount(); row++) list << proxy.index(row, 0).data(RAW_VALUE_ROLE).toInt();
+    return list;
+}
+
+void TstLiveProxyModel::sort_follows_updates() {
+    TableModel model;
+    model.set_head_data(WORK_FREQUENCY, HORIZONTAL_HEAD);
+    LiveProxyModel proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&model);
+    proxy.sort(1, Qt::AscendingOrder);
+
+    for (int id = 0; id < 5; id++) set_frequency(&model, id, 100 - id * 10);
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({4, 3, 2, 1, 0}));
+
+    set_frequency(&model, 4, 1000);
+    set_frequency(&model, 0, 0);
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({0, 3, 2, 1, 4}));
+
+    proxy.sort(1, Qt::DescendingOrder);
+    QCOMPARE(ids(proxy), QList<int>({4, 1, 2, 3, 0}));
+}
+
+void TstLiveProxyModel::hidden_sort_column() {
+    TableModel model;
+    model.set_head_data(WORK_FREQUENCY, HORIZONTAL_HEAD);
+    LiveProxyModel proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&model);
+    proxy.sort(1, Qt::AscendingOrder);
+
+    for (int id = 0; id < 3; id++) set_frequency(&model, id, id);
+    model.update();
+
+    //排序列被隐藏后仍要通知代理, 否则行停在旧位置
+    model.set_field_visible(1, false);
+    set_frequency(&model, 0, 10);
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({1, 2, 0}));
+    QVERIFY(!proxy.index(2, 1).data().isValid());
+}
+
+void TstLiveProxyModel::hidden_filter_column() {
+    TableModel model;
+    model.set_head_data(RADIATION_STATE, HORIZONTAL_HEAD);
+    LiveProxyModel proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&model);
+
+    for (int id = 0; id < 4; id++) set_radiation(&model, id, id % 2);
+    model.update();
+    proxy.set_filter(1, QStringList(QString::fromUtf8("辐射")));
+    QCOMPARE(ids(proxy), QList<int>({0, 2}));
+
+    //过滤列被隐藏后状态变化仍要进出过滤结果
+    model.set_field_visible(1, false);
+    set_radiation(&model, 0, 1);
+    set_radiation(&model, 3, 0);
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({2, 3}));
+
+    //取消过滤后隐藏的非排序列恢复为不通知
+    proxy.set_filter(1, QStringList());
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    set_radiation(&model, 1, 2);
+    model.update();
+    QCOMPARE(changed.count(), 0);
+}
+
+void TstLiveProxyModel::source_removals() {
+    TableModel model;
+    model.set_head_data(WORK_FREQUENCY, HORIZONTAL_HEAD);
+    LiveProxyModel proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&model);
+    proxy.sort(1, Qt::DescendingOrder);
+
+    for (int id = 0; id < 8; id++) set_frequency(&model, id, id);
+    model.update();
+
+    //源模型同一批次删除多个区间并追加新行, 代理中剩余行的映射保持正确
+    remove(&model, 0);
+    remove(&model, 3);
+    remove(&model, 4);
+    remove(&model, 7);
+    set_frequency(&model, 8, 2.5);
+    set_frequency(&model, 5, -1);
+    model.update();
+
+    QCOMPARE(ids(proxy), QList<int>({6, 8, 2, 1, 5}));
+    for (int row = 0; row < proxy.rowCount(); row++) {
+        QModelIndex source = proxy.mapToSource(proxy.index(row, 0));
+        QCOMPARE(proxy.mapFromSource(source).row(), row);
+    }
+}
+
+void TstLiveProxyModel::keyed_source_inserts() {
+    KeyedTableModel model;
+    model.set_head_data(FIREPOWER_UNIT_AISLE, HORIZONTAL_HEAD);
+    LiveProxyModel proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&model);
+    proxy.sort(2, Qt::AscendingOrder);
+
+    //按主键排列的源模型在中间插入行, 代理中已有行的源行号随之平移
+    FirepowerUnitAisle data = {0, 0, 0};
+    for (int unit = 0; unit < 6; unit += 2) {
+        data.unit_id = unit;
+        data.status = 4 - unit;
+        model.add_data(data);
+    }
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({4, 2, 0}));
+
+    data.unit_id = 1;
+    data.status = 3;
+    model.add_data(data);
+    data.unit_id = -1;
+    data.status = 1;
+    model.add_data(data);
+    model.update();
+    QCOMPARE(ids(proxy), QList<int>({4, -1, 2, 1, 0}));
+}
+
+QTEST_MAIN(TstLiveProxyModel)
+#include "tst_live_proxy_model.moc"
@@ -0,0 +1,26 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_live_proxy_model
+TEMPLATE = app
+
+SOURCES += \
+    $${ROOT}/src/models/column_store.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    $${ROOT}/src/models/element_registry.cpp \
+    $${ROOT}/src/models/keyed_tablemodel.cpp \
+    $${ROOT}/src/models/live_proxy_model.cpp \
+    $${ROOT}/src/models/tablemodel.cpp \
+    tst_live_proxy_model.cpp
+
+HEADERS += \
+    $${ROOT}/src/models/column_store.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h \
+    $${ROOT}/src/models/element_registry.h \
+    $${ROOT}/src/models/elements.h \
+    $${ROOT}/src/models/keyed_tablemodel.h \
+    $${ROOT}/src/models/live_proxy_model.h \
+    $${ROOT}/src/models/tablemodel.h
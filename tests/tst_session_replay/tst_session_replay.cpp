@@ -0,0 +1,175 @@
+#include <QFile>
+#include <QHash>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "src/io/replay_engine.h"
+#include "src/io/session_reader.h"
+#include "src/io/session_recorder.h"
+#include "test_records.h"
+
+//每块 256 条, 间隔 10ms, 每块约 2.5s, 约四块一个关键帧
+static const int TOTAL_RECORDS = 4096;
+static const int FLUSH_RECORDS = 256;
+static const int KEY_COUNT = 50;
+
+class TstSessionReplay : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void complete_file();
+    void truncated_without_trailer();
+    void truncated_inside_chunk();
+    void not_a_session();
+    void replay_skips_corrupt_chunk();
+
+private:
+    void write_session();
+    //依次列出各 RECS 块头的文件偏移
+    QList<qint64> chunk_offsets() const;
+    void truncate_to(qint64 size) const;
+
+    QTemporaryDir dir_;
+    QString path_;
+};
+
+void TstSessionReplay::init() {
+    QVERIFY(dir_.isValid());
+    path_ = dir_.filePath("session.edcs");
+    write_session();
+}
+
+void TstSessionReplay::write_session() {
+    SessionRecorder recorder;
+    QVERIFY(recorder.open(path_));
+    for (int i = 0; i < TOTAL_RECORDS; i += FLUSH_RECORDS) {
+        QVector<ElementRecord> records;
+        for (int j = i; j < i + FLUSH_RECORDS; j++) records.append(make_frequency(j % KEY_COUNT, j, j * 10));
+        recorder.append(records);
+        recorder.flush();
+    }
+    recorder.close();
+    QCOMPARE(recorder.recorded_records(), quint64(TOTAL_RECORDS));
+}
+
+QList<qint64> TstSessionReplay::chunk_offsets() const {
+    QList<qint64> offsets;
+    QFile file(path_);
+    if (!file.open(QFile::ReadOnly)) return offsets;
+
+    qint64 offset = sizeof(SessionFileHeader);
+    SessionBlockHeader block;
+    while (file.seek(offset) && file.read(reinterpret_cast<char *>(&block), sizeof(block)) == sizeof(block)) {
+        if (block.tag == SESSION_TAG_RECORDS) offsets << offset;
+        offset += sizeof(block) + block.size;
+    }
+    return offsets;
+}
+
+void TstSessionReplay::truncate_to(qint64 size) const {
+    QFile file(path_);
+    QVERIFY(file.resize(size));
+}
+
+void TstSessionReplay::complete_file() {
+    SessionReader reader;
+    QString error;
+    QVERIFY2(reader.open(path_, &error), qPrintable(error));
+    QVERIFY(!reader.recovered());
+    QCOMPARE(reader.chunk_count(), TOTAL_RECORDS / FLUSH_RECORDS);
+    QVERIFY(reader.keyframe_count() > 1);
+    QCOMPARE(reader.first_timestamp(), qint64(0));
+    QCOMPARE(reader.last_timestamp(), qint64(TOTAL_RECORDS - 1) * 10);
+}
+
+void TstSessionReplay::truncated_without_trailer() {
+    //异常退出: 文件尾没有写出, 顺序扫描恢复全部完整的块
+    QList<qint64> offsets = chunk_offsets();
+    QFile file(path_);
+    qint64 size = file.size() - static_cast<qint64>(sizeof(SessionBlockHeader) + sizeof(SessionTrailer));
+    truncate_to(size);
+
+    SessionReader reader;
+    QString error;
+    QVERIFY2(reader.open(path_, &error), qPrintable(error));
+    QVERIFY(reader.recovered());
+    QCOMPARE(reader.chunk_count(), offsets.size());
+    for (int chunk = 0; chunk < reader.chunk_count(); chunk++) {
+        int count = 0;
+        QVERIFY(reader.chunk_records(chunk, &count) != nullptr);
+        QCOMPARE(count, FLUSH_RECORDS);
+    }
+    QCOMPARE(reader.last_timestamp(), qint64(TOTAL_RECORDS - 1) * 10);
+}
+
+void TstSessionReplay::truncated_inside_chunk() {
+    //写到最后一块中间时中断, 不完整的块忽略, 之前的块和关键帧仍可用
+    QList<qint64> offsets = chunk_offsets();
+    truncate_to(offsets.last() + sizeof(SessionBlockHeader) + sizeof(SessionChunkHeader) + 100);
+
+    SessionReader reader;
+    QString error;
+    QVERIFY2(reader.open(path_, &error), qPrintable(error));
+    QVERIFY(reader.recovered());
+    QCOMPARE(reader.chunk_count(), offsets.size() - 1);
+    QCOMPARE(reader.last_timestamp(), qint64(TOTAL_RECORDS - FLUSH_RECORDS - 1) * 10);
+    QVERIFY(reader.keyframe_count() > 0);
+
+    int count = 0;
+    QVERIFY(reader.keyframe_records(reader.keyframe_count() - 1, &count) != nullptr);
+    QCOMPARE(count, KEY_COUNT);
+}
+
+void TstSessionReplay::not_a_session() {
+    truncate_to(sizeof(SessionFileHeader) - 1);
+
+    SessionReader reader;
+    QString error;
+    QVERIFY(!reader.open(path_, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!reader.is_open());
+}
+
+void TstSessionReplay::replay_skips_corrupt_chunk() {
+    //破坏中间一块的块头, 文件尾完整, 索引仍指向该块
+    QList<qint64> offsets = chunk_offsets();
+    {
+        QFile file(path_);
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.seek(offsets.at(5)));
+        QCOMPARE(file.write("XXXX", 4), qint64(4));
+    }
+
+    ReplayEngine engine;
+    QHash<qint64, double> state;
+    int resets = 0;
+    connect(&engine, &ReplayEngine::sig_reset, this, [&] {
+        state.clear();
+        resets++;
+    });
+    connect(&engine, &ReplayEngine::sig_records, this, [&](const QVector<ElementRecord> &records) {
+        for (const ElementRecord &record : records) state.insert(record.key, frequency_of(record));
+    });
+    QSignalSpy errors(&engine, &ReplayEngine::sig_error);
+    QSignalSpy finished(&engine, &ReplayEngine::sig_finished);
+
+    QString error;
+    QVERIFY2(engine.open(path_, &error), qPrintable(error));
+    engine.set_speed(0);
+    engine.play();
+    QVERIFY(finished.wait(10000));
+
+    //跳过损坏块后在下一个关键帧恢复, 最终状态与完整回放相同
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(resets, 2);
+    QCOMPARE(state.size(), KEY_COUNT);
+    for (int key = 0; key < KEY_COUNT; key++) {
+        int last = TOTAL_RECORDS - 1 - (TOTAL_RECORDS - 1 - key) % KEY_COUNT;
+        QCOMPARE(state.value(key), double(last));
+    }
+}
+
+QTEST_GUILESS_MAIN(TstSessionReplay)
+#include "tst_session_replay.moc"
@@ -0,0 +1,20 @@
+include(../tests.pri)
+
+TARGET = tst_session_replay
+TEMPLATE = app
+
+SOURCES += \
+    $${ROOT}/src/io/replay_engine.cpp \
+    $${ROOT}/src/io/session_reader.cpp \
+    $${ROOT}/src/io/session_recorder.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    tst_session_replay.cpp
+
+HEADERS += \
+    $${ROOT}/src/io/replay_engine.h \
+    $${ROOT}/src/io/session_format.h \
+    $${ROOT}/src/io/session_reader.h \
+    $${ROOT}/src/io/session_recorder.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h
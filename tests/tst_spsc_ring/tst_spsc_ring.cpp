@@ -0,0 +1,101 @@
+#include <QtTest>
+#include <thread>
+
+#include "src/utils/spsc_ring.h"
+
+class TestSpscRing : public QObject {
+    Q_OBJECT
+
+private slots:
+    void capacity_rounds_up();
+    void full_and_empty();
+    void wrap_around();
+    void producer_drops_oldest();
+    void two_threads();
+};
+
+void TestSpscRing::capacity_rounds_up() {
+    QCOMPARE(SpscRing<int>(1).capacity(), 2);
+    QCOMPARE(SpscRing<int>(5).capacity(), 8);
+    QCOMPARE(SpscRing<int>(8).capacity(), 8);
+}
+
+void TestSpscRing::full_and_empty() {
+    SpscRing<int> ring(4);
+    int value = 0;
+    QVERIFY(!ring.try_pop(&value));
+
+    for (int i = 0; i < 4; i++) QVERIFY(ring.try_push(i));
+    QVERIFY(!ring.try_push(4));
+    QCOMPARE(ring.size(), 4);
+    QCOMPARE(ring.high_water(), 4);
+
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(ring.try_pop(&value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.try_pop(&value));
+    QCOMPARE(ring.size(), 0);
+}
+
+void TestSpscRing::wrap_around() {
+    //读写位置多次绕过槽数组, 顺序和高水位保持正确
+    SpscRing<int> ring(4);
+    int next_push = 0, next_pop = 0, value = 0;
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 3; i++) QVERIFY(ring.try_push(next_push++));
+        for (int i = 0; i < 3; i++) {
+            QVERIFY(ring.try_pop(&value));
+            QCOMPARE(value, next_pop++);
+        }
+    }
+    QCOMPARE(ring.high_water(), 3);
+    QVERIFY(!ring.try_pop(&value));
+}
+
+void TestSpscRing::producer_drops_oldest() {
+    //生产者在队列满时先出队一条再入队, 队列中保留最新的数据
+    SpscRing<int> ring(4);
+    int value = 0;
+    for (int i = 0; i < 10; i++) {
+        if (!ring.try_push(i)) {
+            QVERIFY(ring.try_pop(&value));
+            QVERIFY(ring.try_push(i));
+        }
+    }
+    for (int i = 6; i < 10; i++) {
+        QVERIFY(ring.try_pop(&value));
+        QCOMPARE(value, i);
+    }
+}
+
+void TestSpscRing::two_threads() {
+    //一个线程写入, 一个线程读出, 不丢失也不乱序
+    const int count = 200000;
+    SpscRing<int> ring(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; i++) {
+            while (!ring.try_push(i)) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0, value = 0;
+    bool ordered = true;
+    while (expected < count) {
+        if (!ring.try_pop(&value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != expected) ordered = false;
+        expected++;
+    }
+    producer.join();
+
+    QVERIFY(ordered);
+    QVERIFY(ring.high_water() <= ring.capacity());
+}
+
+QTEST_APPLESS_MAIN(TestSpscRing)
+
+#include "tst_spsc_ring.moc"
@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_spsc_ring
+TEMPLATE = app
+
+SOURCES += \
+    tst_spsc_ring.cpp
+
+HEADERS += \
+    $${ROOT}/src/utils/spsc_ring.h
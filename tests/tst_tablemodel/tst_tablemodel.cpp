@@ -0,0 +1,192 @@
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "src/models/tablemodel.h"
+#include "test_records.h"
+
+class TstTableModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void batch_removals();
+    void removals_with_updates();
+    void remove_unpublished();
+    void upsert_removed_key();
+    void removal_records();
+    void unknown_codes();
+
+private:
+    //发布 id 为 0..count-1 的工作频点, 频点为 id
+    static void fill(TableModel *pmodel, int count);
+    static void set_frequency(TableModel *pmodel, int id, double frequency);
+    static void remove(TableModel *pmodel, int id);
+    static QList<int> ids(const TableModel &model);
+};
+
+void TstTableModel::fill(TableModel *pmodel, int count) {
+    pmodel->set_head_data(WORK_FREQUENCY, HORIZONTAL_HEAD);
+    for (int id = 0; id < count; id++) set_frequency(pmodel, id, id);
+    pmodel->update();
+}
+
+void TstTableModel::set_frequency(TableModel *pmodel, int id, double frequency) {
+    WorkFrequency data;
+    data.id = id;
+    data.frequency_point = frequency;
+    pmodel->add_data(data);
+}
+
+void TstTableModel::remove(TableModel *pmodel, int id) {
+    WorkFrequency data;
+    data.id = id;
+    data.frequency_point = 0;
+    pmodel->remove_data(&data, WORK_FREQUENCY);
+}
+
+QList<int> TstTableModel::ids(const TableModel &model) {
+    QList<int> list;
+    for (int row = 0; row < model.rowCount(); row++) list << model.index(row, 0).data(RAW_VALUE_ROLE).toInt();
+    return list;
+}
+
+void TstTableModel::batch_removals() {
+    TableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    fill(&model, 10);
+
+    //头部, 中间的连续两条, 尾部在同一批次中删除, 从后往前每个区间通知一次
+    QSignalSpy spy(&model, &QAbstractItemModel::rowsRemoved);
+    remove(&model, 5);
+    remove(&model, 0);
+    remove(&model, 9);
+    remove(&model, 4);
+    QVERIFY(model.has_pending());
+    QCOMPARE(model.rowCount(), 10);
+    model.update();
+
+    QCOMPARE(ids(model), QList<int>({1, 2, 3, 6, 7, 8}));
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(0).at(1).toInt(), 9);
+    QCOMPARE(spy.at(0).at(2).toInt(), 9);
+    QCOMPARE(spy.at(1).at(1).toInt(), 4);
+    QCOMPARE(spy.at(1).at(2).toInt(), 5);
+    QCOMPARE(spy.at(2).at(1).toInt(), 0);
+    QCOMPARE(spy.at(2).at(2).toInt(), 0);
+    QVERIFY(!model.has_pending());
+}
+
+void TstTableModel::removals_with_updates() {
+    TableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    fill(&model, 10);
+
+    //删除前面的记录后, 同批次的更新按移动后的行号通知
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    set_frequency(&model, 8, 80);
+    remove(&model, 0);
+    set_frequency(&model, 1, 10);
+    remove(&model, 5);
+    model.update();
+
+    QCOMPARE(ids(model), QList<int>({1, 2, 3, 4, 6, 7, 8, 9}));
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(0).at(0).toModelIndex().row(), 0);
+    QCOMPARE(spy.at(1).at(0).toModelIndex().row(), 6);
+    QCOMPARE(model.index(0, 1).data(RAW_VALUE_ROLE).toDouble(), 10.0);
+    QCOMPARE(model.index(6, 1).data(RAW_VALUE_ROLE).toDouble(), 80.0);
+}
+
+void TstTableModel::remove_unpublished() {
+    TableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    fill(&model, 5);
+
+    //本批次新增又删除的记录视图从未见过, 不发删除通知
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    set_frequency(&model, 10, 10);
+    set_frequency(&model, 11, 11);
+    remove(&model, 11);
+    remove(&model, 4);
+    model.update();
+
+    QCOMPARE(ids(model), QList<int>({0, 1, 2, 3, 10}));
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 4);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 4);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 4);
+}
+
+void TstTableModel::upsert_removed_key() {
+    TableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    fill(&model, 5);
+
+    //删除后同批次再次写入同一主键: 旧行删除, 新记录追加到末尾
+    remove(&model, 2);
+    set_frequency(&model, 2, 20);
+    model.update();
+    QCOMPARE(ids(model), QList<int>({0, 1, 3, 4, 2}));
+    QCOMPARE(model.index(4, 1).data(RAW_VALUE_ROLE).toDouble(), 20.0);
+
+    //主键索引已重建, 之后的写入原地更新而不是再追加一行
+    set_frequency(&model, 2, 21);
+    set_frequency(&model, 3, 30);
+    model.update();
+    QCOMPARE(ids(model), QList<int>({0, 1, 3, 4, 2}));
+    QCOMPARE(model.index(4, 1).data(RAW_VALUE_ROLE).toDouble(), 21.0);
+    QCOMPARE(model.index(2, 1).data(RAW_VALUE_ROLE).toDouble(), 30.0);
+
+    //下一批次删除后再写入
+    remove(&model, 2);
+    model.update();
+    set_frequency(&model, 2, 22);
+    model.update();
+    QCOMPARE(ids(model), QList<int>({0, 1, 3, 4, 2}));
+    QCOMPARE(model.index(4, 1).data(RAW_VALUE_ROLE).toDouble(), 22.0);
+}
+
+void TstTableModel::removal_records() {
+    TableModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    fill(&model, 4);
+
+    //解码后的删除记录与 remove_data 等效
+    QVector<ElementRecord> records;
+    records << make_frequency(1, 0) << make_frequency(4, 40) << make_frequency(3, 0);
+    records[0].flags = RECORD_REMOVED;
+    records[2].flags = RECORD_REMOVED;
+    model.add_records(records.constData(), records.size());
+    model.update();
+
+    QCOMPARE(ids(model), QList<int>({0, 2, 4}));
+}
+
+void TstTableModel::unknown_codes() {
+    TableModel model;
+    model.set_head_data(RADIATION_STATE, HORIZONTAL_HEAD);
+
+    RadiationState data;
+    data.equipment_id = 1;
+    data.radiation_state = 1;
+    model.add_data(data);
+    data.equipment_id = 2;
+    data.radiation_state = 7;
+    model.add_data(data);
+    data.equipment_id = 3;
+    data.radiation_state = -1;
+    model.add_data(data);
+    model.update();
+
+    //超出文字表的代码显示兜底文字并计数, 排序仍使用原始代码
+    QCOMPARE(model.unknown_codes(), quint64(2));
+    QCOMPARE(model.index(0, 1).data().toString(), QString::fromUtf8("静默"));
+    QCOMPARE(model.index(1, 1).data().toString(), ElementRegistry::instance().unknown_label());
+    QCOMPARE(model.index(2, 1).data().toString(), ElementRegistry::instance().unknown_label());
+    QCOMPARE(model.index(1, 1).data(RAW_VALUE_ROLE).toInt(), 7);
+}
+
+QTEST_MAIN(TstTableModel)
+#include "tst_tablemodel.moc"
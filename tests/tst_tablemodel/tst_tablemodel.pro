@@ -0,0 +1,22 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_tablemodel
+TEMPLATE = app
+
+SOURCES += \
+    $${ROOT}/src/models/column_store.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    $${ROOT}/src/models/element_registry.cpp \
+    $${ROOT}/src/models/tablemodel.cpp \
+    tst_tablemodel.cpp
+
+HEADERS += \
+    $${ROOT}/src/models/column_store.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h \
+    $${ROOT}/src/models/element_registry.h \
+    $${ROOT}/src/models/elements.h \
+    $${ROOT}/src/models/tablemodel.h
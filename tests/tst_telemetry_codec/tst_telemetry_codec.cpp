@@ -0,0 +1,104 @@
+#include <QtTest>
+
+#include "src/io/telemetry_codec.h"
+#include "test_records.h"
+
+class TestTelemetryCodec : public QObject {
+    Q_OBJECT
+
+private slots:
+    void round_trip();
+    void truncated();
+    void corrupt_header();
+    void frames_back_to_back();
+    void remove_flag();
+
+private:
+    QByteArray frame(int count);
+};
+
+QByteArray TestTelemetryCodec::frame(int count) {
+    QVector<ElementRecord> records;
+    for (int i = 0; i < count; i++) records.append(make_frequency(i, 1000.5 + i));
+    return TelemetryCodec::encode_frame(WORK_FREQUENCY, records.constData(), records.size(), 7);
+}
+
+void TestTelemetryCodec::round_trip() {
+    QByteArray data = frame(3);
+    QVector<ElementRecord> records;
+    int frame_size = 0;
+    QCOMPARE(TelemetryCodec::decode_frame(data.constData(), data.size(), 42, &records, &frame_size), DECODE_OK);
+    QCOMPARE(frame_size, data.size());
+    QCOMPARE(records.size(), 3);
+    for (int i = 0; i < 3; i++) {
+        QCOMPARE(records.at(i).type, static_cast<qint32>(WORK_FREQUENCY));
+        QCOMPARE(records.at(i).key, static_cast<qint64>(i));
+        QCOMPARE(records.at(i).timestamp, static_cast<qint64>(42));
+        QCOMPARE(frequency_of(records.at(i)), 1000.5 + i);
+        QCOMPARE(records.at(i).flags, 0);
+    }
+}
+
+void TestTelemetryCodec::remove_flag() {
+    //删除帧中的每条记录都带 RECORD_REMOVED, 主键照常解出
+    ElementRecord record = make_frequency(9, 0);
+    QByteArray data = TelemetryCodec::encode_frame(WORK_FREQUENCY, &record, 1, 8, TELEMETRY_FLAG_REMOVE);
+    QVector<ElementRecord> records;
+    QCOMPARE(TelemetryCodec::decode_frame(data.constData(), data.size(), 0, &records), DECODE_OK);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.at(0).flags, RECORD_REMOVED);
+    QCOMPARE(records.at(0).key, static_cast<qint64>(9));
+}
+
+void TestTelemetryCodec::truncated() {
+    //不足帧头、不足声明的记录都返回 DECODE_TRUNCATED, 且不追加记录
+    QByteArray data = frame(3);
+    QVector<ElementRecord> records;
+    QCOMPARE(TelemetryCodec::decode_frame(data.constData(), 0, 0, &records), DECODE_TRUNCATED);
+    QCOMPARE(TelemetryCodec::decode_frame(data.constData(), TELEMETRY_HEADER_SIZE - 1, 0, &records),
+             DECODE_TRUNCATED);
+    QCOMPARE(TelemetryCodec::decode_frame(data.constData(), data.size() - 1, 0, &records), DECODE_TRUNCATED);
+    QVERIFY(records.isEmpty());
+}
+
+void TestTelemetryCodec::corrupt_header() {
+    struct Case {
+        int offset;
+        uchar value;
+        DecodeStatus status;
+    } cases[] = {
+        {0, 0x00, DECODE_BAD_MAGIC},    // magic 高字节
+        {2, 0x7F, DECODE_BAD_VERSION},  // version
+        {3, 0xFF, DECODE_BAD_TYPE},     // type
+        {7, 0x01, DECODE_BAD_LENGTH},   // record_size 低字节
+        {4, 0xFF, DECODE_BAD_LENGTH},   // count 超过 TELEMETRY_MAX_RECORDS
+    };
+
+    for (const Case &c : cases) {
+        QByteArray data = frame(2);
+        data[c.offset] = static_cast<char>(c.value);
+        QVector<ElementRecord> records;
+        QCOMPARE(TelemetryCodec::decode_frame(data.constData(), data.size(), 0, &records), c.status);
+        QVERIFY(records.isEmpty());
+    }
+}
+
+void TestTelemetryCodec::frames_back_to_back() {
+    //多帧首尾相接时按 frame_size 逐帧解码
+    QByteArray data = frame(2) + frame(1);
+    QVector<ElementRecord> records;
+    const char *p = data.constData();
+    int remain = data.size(), frame_size = 0, frames = 0;
+    while (remain > 0 && TelemetryCodec::decode_frame(p, remain, 0, &records, &frame_size) == DECODE_OK) {
+        p += frame_size;
+        remain -= frame_size;
+        frames++;
+    }
+    QCOMPARE(frames, 2);
+    QCOMPARE(remain, 0);
+    QCOMPARE(records.size(), 3);
+}
+
+QTEST_APPLESS_MAIN(TestTelemetryCodec)
+
+#include "tst_telemetry_codec.moc"
@@ -0,0 +1,15 @@
+include(../tests.pri)
+
+TARGET = tst_telemetry_codec
+TEMPLATE = app
+
+SOURCES += \
+    $${ROOT}/src/io/telemetry_codec.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    tst_telemetry_codec.cpp
+
+HEADERS += \
+    $${ROOT}/src/io/telemetry_codec.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h
@@ -0,0 +1,120 @@
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "src/io/telemetry_receiver.h"
+#include "test_records.h"
+
+/*
+ *  以文件作为数据源驱动接收器, 一帧携带的记录数超过队列容量, 检查两种溢出策略
+ */
+class TestTelemetryReceiver : public QObject {
+    Q_OBJECT
+
+private slots:
+    void drop_oldest();
+    void keep_latest();
+    void corrupt_frames();
+
+private:
+    //把 ids[i] / 频点 i 的记录编成一帧写入文件
+    QString write_frames(const QVector<QByteArray> &frames);
+    QByteArray frame(const QVector<int> &ids);
+    //等待接收器取完 count 条记录
+    QVector<ElementRecord> take(TelemetryReceiver *preceiver, int count);
+
+private:
+    QTemporaryDir dir_;
+    int files_ = 0;
+};
+
+QByteArray TestTelemetryReceiver::frame(const QVector<int> &ids) {
+    QVector<ElementRecord> records;
+    for (int i = 0; i < ids.size(); i++) records.append(make_frequency(ids.at(i), i));
+    return TelemetryCodec::encode_frame(WORK_FREQUENCY, records.constData(), records.size(), 0);
+}
+
+QString TestTelemetryReceiver::write_frames(const QVector<QByteArray> &frames) {
+    QString path = dir_.filePath(QString("frames_%1.bin").arg(files_++));
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly)) return QString();
+    for (const QByteArray &data : frames) file.write(data);
+    return path;
+}
+
+QVector<ElementRecord> TestTelemetryReceiver::take(TelemetryReceiver *preceiver, int count) {
+    QVector<ElementRecord> records;
+    QElapsedTimer clock;
+    clock.start();
+    while (records.size() < count && clock.elapsed() < 5000) {
+        preceiver->take_records(&records);
+        QTest::qWait(10);
+    }
+    return records;
+}
+
+void TestTelemetryReceiver::drop_oldest() {
+    //20 条不同主键的记录进入容量为 8 的队列, 保留最新的 8 条
+    QVector<int> ids;
+    for (int i = 0; i < 20; i++) ids.append(i);
+
+    TelemetryReceiver receiver(8);
+    receiver.set_overflow_policy(OVERFLOW_DROP_OLDEST);
+    receiver.set_file_source(write_frames({frame(ids)}), 1);
+    receiver.start();
+    QTRY_COMPARE(receiver.decoded_records(), quint64(20));
+
+    RingStats stats = receiver.ring_stats();
+    QCOMPARE(stats.capacity, 8);
+    QCOMPARE(stats.high_water, 8);
+    QCOMPARE(stats.pushed, quint64(20));
+    QCOMPARE(stats.dropped, quint64(12));
+
+    QVector<ElementRecord> records = take(&receiver, 8);
+    QCOMPARE(records.size(), 8);
+    for (int i = 0; i < 8; i++) QCOMPARE(records.at(i).key, qint64(12 + i));
+}
+
+void TestTelemetryReceiver::keep_latest() {
+    //主键 0..9 各出现两次; 前 8 条入队, 其余暂存, 暂存区中同一主键只保留最新值
+    QVector<int> ids;
+    for (int i = 0; i < 20; i++) ids.append(i % 10);
+
+    TelemetryReceiver receiver(8);
+    receiver.set_overflow_policy(OVERFLOW_KEEP_LATEST);
+    receiver.set_file_source(write_frames({frame(ids)}), 1);
+    receiver.start();
+    QTRY_COMPARE(receiver.decoded_records(), quint64(20));
+    QCOMPARE(receiver.ring_stats().dropped, quint64(2));
+
+    //取走后暂存的 10 个主键陆续补入队列
+    QVector<ElementRecord> records = take(&receiver, 18);
+    QCOMPARE(records.size(), 18);
+    QCOMPARE(receiver.ring_stats().pushed, quint64(18));
+
+    QHash<qint64, double> latest;
+    for (const ElementRecord &record : records) latest.insert(record.key, frequency_of(record));
+    QCOMPARE(latest.size(), 10);
+    for (int id = 0; id < 10; id++) QCOMPARE(latest.value(id), double(id + 10));
+}
+
+void TestTelemetryReceiver::corrupt_frames() {
+    //坏帧之间的正常帧照常解码, 连续的坏数据只计一次, 文件末尾不完整的帧不计为坏帧
+    QByteArray good = frame({1, 2});
+    QByteArray bad_magic = good;
+    bad_magic[0] = 0;
+    QByteArray bad_length = good;
+    bad_length[7] = 1;
+
+    TelemetryReceiver receiver(64);
+    receiver.set_file_source(write_frames({good, bad_magic, good, bad_length, good, good.left(good.size() - 3)}), 1);
+    receiver.start();
+    QTRY_COMPARE(receiver.decoded_records(), quint64(6));
+    QTest::qWait(50);
+
+    QCOMPARE(receiver.decoded_records(), quint64(6));
+    QCOMPARE(receiver.rejected_frames(), quint64(2));
+}
+
+QTEST_GUILESS_MAIN(TestTelemetryReceiver)
+
+#include "tst_telemetry_receiver.moc"
@@ -0,0 +1,23 @@
+include(../tests.pri)
+
+QT += network
+
+TARGET = tst_telemetry_receiver
+TEMPLATE = app
+
+SOURCES += \
+    $${ROOT}/src/io/session_recorder.cpp \
+    $${ROOT}/src/io/telemetry_codec.cpp \
+    $${ROOT}/src/io/telemetry_receiver.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    tst_telemetry_receiver.cpp
+
+HEADERS += \
+    $${ROOT}/src/io/session_format.h \
+    $${ROOT}/src/io/session_recorder.h \
+    $${ROOT}/src/io/telemetry_codec.h \
+    $${ROOT}/src/io/telemetry_receiver.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h \
+    $${ROOT}/src/utils/spsc_ring.h
@@ -0,0 +1,85 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+
+#include "src/utils/command_line.h"
+#include "telemetry_generator.h"
+
+//命令行中的类型名, 按 ElementType 顺序
+static const char *const type_names[ELEMENT_TYPE_COUNT] = {
+    "system", "pattern",     "radiation", "frequency", "disturb", "region", "command",
+    "photo",  "interceptor", "gbi",       "radar",     "unit",    "aisle",
+};
+
+static int type_of(const QString &name) {
+    for (int i = 0; i < ELEMENT_TYPE_COUNT; i++) {
+        if (name == type_names[i]) return i;
+    }
+    bool ok = false;
+    int type = name.toInt(&ok);
+    return (ok && type >= 0 && type < ELEMENT_TYPE_COUNT) ? type : -1;
+}
+
+/*
+ *  用法: telemetry_generator [选项]
+ *      --host <地址>              目标地址(默认 127.0.0.1)
+ *      --udp-port <端口>          目标端口(默认 6000)
+ *      --frame-file <文件>        写入帧文件而不发送, 供主程序 --frame-file 回放
+ *      --rate <频率>              每个实体每秒更新次数(默认 10)
+ *      --count <类型>=<数量>      实体数量, 可重复; 类型为名称或 ElementType 编号
+ *      --duration <秒>            运行时长, 0 表示一直运行(默认 0)
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    TelemetryGenerator generator;
+    QTextStream err(stderr);
+
+    for (int pos = 1; pos + 1 < args.size(); pos++) {
+        if (args.at(pos) != "--count") continue;
+        QStringList pair = args.at(pos + 1).split('=');
+        int type = pair.size() == 2 ? type_of(pair.at(0)) : -1;
+        if (type < 0) {
+            err << "无效的 --count 参数: " << args.at(pos + 1) << endl;
+            return 1;
+        }
+        bool ok = false;
+        int count = pair.at(1).toInt(&ok);
+        if (!ok || count < 0) {
+            err << "无效的 --count 数量: " << args.at(pos + 1) << endl;
+            return 1;
+        }
+        generator.set_count(static_cast<ElementType>(type), count);
+    }
+
+    //取值无效时 arg_int/arg_double 已输出警告, 直接退出
+    bool ok = true;
+    generator.set_rate(arg_double(args, "--rate", 10.0, 0.0, 1e6, &ok));
+    if (!ok) return 1;
+
+    QString frame_file = arg_value(args, "--frame-file");
+    if (!frame_file.isEmpty()) {
+        QString error;
+        if (!generator.set_file_target(frame_file, &error)) {
+            err << "无法打开 " << frame_file << ": " << error << endl;
+            return 1;
+        }
+    } else {
+        QString host = arg_value(args, "--host");
+        QHostAddress address = host.isEmpty() ? QHostAddress(QHostAddress::LocalHost) : QHostAddress(host);
+        if (address.isNull()) {
+            err << "无效的 --host 地址: " << host << endl;
+            return 1;
+        }
+        quint16 port = static_cast<quint16>(arg_int(args, "--udp-port", 6000, 1, 65535, &ok));
+        if (!ok) return 1;
+        generator.set_udp_target(address, port);
+    }
+
+    int duration = arg_int(args, "--duration", 0, 0, INT_MAX, &ok);
+    if (!ok) return 1;
+
+    QObject::connect(&generator, &TelemetryGenerator::sig_finished, &app, &QCoreApplication::quit);
+    generator.start(duration);
+    return app.exec();
+}
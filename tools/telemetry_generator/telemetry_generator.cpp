@@ -0,0 +1,286 @@
+#include "telemetry_generator.h"
+
+#include <QTextStream>
+#include <cmath>
+
+#include "src/io/telemetry_codec.h"
+
+//单个 UDP 报文的负载上限, 留出余量避免分片失败
+static const int MAX_DATAGRAM_SIZE = 60000;
+static const double PI = 3.14159265358979323846;
+//实体分布的中心位置
+static const double CENTER_LON = 116.4;
+static const double CENTER_LAT = 39.9;
+
+//默认实体数量, 按 ElementType 顺序
+static const int default_counts[ELEMENT_TYPE_COUNT] = {
+    1,    //雷达系统状态
+    8,    //工作模式
+    32,   //辐射状态
+    32,   //工作频点
+    16,   //有源干扰方向
+    1,    //搜索区域
+    1,    //指控系统状态
+    64,   //光电装备
+    1,    //拦截武器
+    48,   //拦截弹资源
+    16,   //制导雷达
+    1,    //火力单元
+    5000, //火力单元通道
+};
+
+template <typename T>
+static void pack(const T &data, ElementRecord *precord) {
+    pack_element(*element_descriptor(ElementTraits<T>::type), &data, precord);
+}
+
+TelemetryGenerator::TelemetryGenerator(QObject *parent) : QObject(parent) {
+    for (int i = 0; i < ELEMENT_TYPE_COUNT; i++) {
+        counts_[i] = default_counts[i];
+        next_[i] = 0;
+        due_[i] = 0.0;
+    }
+
+    timer_.setTimerType(Qt::PreciseTimer);
+    connect(&timer_, &QTimer::timeout, this, &TelemetryGenerator::on_timer);
+}
+
+void TelemetryGenerator::set_count(ElementType type, int count) {
+    const ElementDescriptor *pdesc = element_descriptor(type);
+    if (pdesc == nullptr) return;
+    bool keyed = pdesc->key_fields[0] >= 0 || pdesc->key_fields[1] >= 0;
+    counts_[type] = keyed ? qMax(0, count) : qBound(0, count, 1);
+    next_[type] = 0;
+}
+
+void TelemetryGenerator::set_udp_target(const QHostAddress &address, quint16 port) {
+    file_.close();
+    address_ = address;
+    port_ = port;
+}
+
+bool TelemetryGenerator::set_file_target(const QString &path, QString *perror) {
+    file_.close();
+    file_.setFileName(path);
+    if (!file_.open(QFile::WriteOnly | QFile::Truncate)) {
+        if (perror != nullptr) *perror = file_.errorString();
+        return false;
+    }
+    return true;
+}
+
+void TelemetryGenerator::start(int duration_s) {
+    duration_ms_ = qMax(0, duration_s) * 1000LL;
+    last_ms_ = 0;
+    report_ms_ = 0;
+    clock_.start();
+    timer_.start(10);
+}
+
+void TelemetryGenerator::on_timer() {
+    qint64 now = clock_.elapsed();
+    double dt = (now - last_ms_) / 1000.0;
+    double t = now / 1000.0;
+    last_ms_ = now;
+
+    //每种类型按 实体数 x 频率 累计应发条数, 实体轮流更新, 卡顿后最多补一轮
+    for (int type = 0; type < ELEMENT_TYPE_COUNT; type++) {
+        int count = counts_[type];
+        if (count <= 0) continue;
+
+        due_[type] = qMin(due_[type] + count * rate_ * dt, static_cast<double>(count));
+        int n = static_cast<int>(due_[type]);
+        if (n <= 0) continue;
+        due_[type] -= n;
+
+        records_.resize(n);
+        for (int i = 0; i < n; i++) {
+            fill_record(static_cast<ElementType>(type), next_[type], t, &records_[i]);
+            next_[type] = (next_[type] + 1) % count;
+        }
+        send(static_cast<ElementType>(type), records_.constData(), n);
+    }
+
+    if (now - report_ms_ >= 1000) report(now);
+    if (duration_ms_ > 0 && now >= duration_ms_) {
+        timer_.stop();
+        file_.close();
+        report(now);
+        emit sig_finished();
+    }
+}
+
+void TelemetryGenerator::send(ElementType type, const ElementRecord *records, int count) {
+    //按报文长度和单帧条数上限分帧
+    int record_size = element_packed_size(*element_descriptor(type));
+    int frame_records = qMin(TELEMETRY_MAX_RECORDS, (MAX_DATAGRAM_SIZE - TELEMETRY_HEADER_SIZE) / record_size);
+
+    for (int first = 0; first < count; first += frame_records) {
+        int n = qMin(frame_records, count - first);
+        QByteArray frame = TelemetryCodec::encode_frame(type, records + first, n, sequence_++);
+
+        bool ok = file_.isOpen() ? file_.write(frame) == frame.size()
+                                 : socket_.writeDatagram(frame, address_, port_) == frame.size();
+        if (ok) {
+            sent_frames_++;
+            sent_records_ += n;
+        } else {
+            failed_frames_++;
+        }
+    }
+}
+
+void TelemetryGenerator::report(qint64 elapsed_ms) {
+    double seconds = qMax<qint64>(1, elapsed_ms - report_ms_) / 1000.0;
+    QTextStream out(stdout);
+    out << QString("%1 s  %2 条/秒  累计 %3 条 %4 帧  失败 %5 帧")
+               .arg(elapsed_ms / 1000)
+               .arg(static_cast<qint64>((sent_records_ - reported_records_) / seconds))
+               .arg(sent_records_)
+               .arg(sent_frames_)
+               .arg(failed_frames_)
+        << endl;
+
+    report_ms_ = elapsed_ms;
+    reported_records_ = sent_records_;
+}
+
+void TelemetryGenerator::fill_record(ElementType type, int index, double t, ElementRecord *precord) const {
+    int count = counts_[type];
+    //每个实体错开相位, 避免所有实体数值相同
+    double phase = 2.0 * PI * index / count;
+
+    switch (type) {
+        case SYSTEM_STATE: {
+            SystemState data;
+            data.power_off = 0;
+            data.control_state = static_cast<int>(t / 20) % 3;
+            data.scanning_mode = static_cast<int>(t / 15) % 4;
+            data.antenna_eleva_angle = 10.0 + 5.0 * std::sin(t * 0.2);
+            data.beam_eleva_angle = std::fmod(t * 30.0, 90.0);
+            data.eccm_measures = static_cast<int>(t) % 5;
+            data.clutter_map = QString("CM-%1").arg(static_cast<int>(t / 60));
+            data.emi_intensity = 50.0 + 30.0 * std::sin(t * 0.5);
+            data.time_alloca_state = std::fmod(t, 100.0);
+            data.track_data_rate = 10.0 + 2.0 * std::sin(t);
+            pack(data, precord);
+            break;
+        }
+        case WORK_PATTERN: {
+            WorkPattern data;
+            data.id = index;
+            data.start_yaw = std::fmod(index * 45.0 + t * 6.0, 360.0);
+            data.end_yaw = std::fmod(data.start_yaw + 60.0, 360.0);
+            pack(data, precord);
+            break;
+        }
+        case RADIATION_STATE: {
+            RadiationState data;
+            data.equipment_id = index;
+            data.radiation_state = (static_cast<int>(t * 0.5) + index) % 3;
+            pack(data, precord);
+            break;
+        }
+        case WORK_FREQUENCY: {
+            WorkFrequency data;
+            data.id = index;
+            data.frequency_point = 3000.0 + index * 10.0 + 5.0 * std::sin(t * 0.3 + phase);
+            pack(data, precord);
+            break;
+        }
+        case DISTURB_DIRECTION: {
+            //干扰方向均匀分布并持续扫描
+            DisturbDirection data;
+            data.id = index;
+            data.eleva_angle = std::fmod(index * 360.0 / count + t * 12.0, 360.0);
+            data.pitch = 20.0 * std::sin(t * 0.4 + phase);
+            data.power = 60.0 + 20.0 * std::sin(t * 0.7 + phase);
+            pack(data, precord);
+            break;
+        }
+        case REGION_OF_SEARCH: {
+            RegionOfSearch data;
+            double lon = CENTER_LON + 0.5 * std::sin(t * 0.01);
+            double lat = CENTER_LAT + 0.5 * std::cos(t * 0.01);
+            data.max_lon = lon + 2.0;
+            data.min_lon = lon - 2.0;
+            data.max_lat = lat + 1.5;
+            data.min_lat = lat - 1.5;
+            pack(data, precord);
+            break;
+        }
+        case CHAIN_OF_COMMAND: {
+            ChainOfCommand data;
+            data.work_state = static_cast<int>(t / 30) % 4;
+            data.war_preparedness_lv = 1 + static_cast<int>(t / 45) % 3;
+            data.equip_state = static_cast<int>(t / 25) % 3;
+            data.combat_permissions = static_cast<int>(t / 40) % 2;
+            data.command_mode = static_cast<int>(t / 35) % 3;
+            pack(data, precord);
+            break;
+        }
+        case PHOTOELECTRICITY_EQUIPMENT: {
+            //绕中心做圆周运动, 周期 300 秒
+            PhotoelectricityEquipment data;
+            double angle = t * 2.0 * PI / 300.0 + phase;
+            double radius = 0.5 + 0.01 * index;
+            data.id = index;
+            data.lon = CENTER_LON + radius * std::cos(angle);
+            data.lat = CENTER_LAT + radius * std::sin(angle);
+            data.alt = 100.0 + index;
+            data.elevation_angle = std::fmod(t * 10.0 + index * 7.0, 360.0);
+            data.pitch_angle = 30.0 * std::sin(t * 0.3 + phase);
+            data.trace_status = (static_cast<int>(t / 10) + index) % 3;
+            pack(data, precord);
+            break;
+        }
+        case DESCRIPTION_OF_INTERCEPTOR_WEAPON: {
+            DescriptionOfInterceptorWeapon data;
+            data.status = static_cast<int>(t / 30) % 4;
+            data.war_readiness_lv = 1 + static_cast<int>(t / 45) % 3;
+            data.operational_authority = static_cast<int>(t / 40) % 2;
+            data.command_mode = static_cast<int>(t / 35) % 3;
+            data.app_mode = static_cast<int>(t / 20) % 4;
+            data.run_status = static_cast<int>(t / 50) % 3;
+            pack(data, precord);
+            break;
+        }
+        case GBI_RESOURCES: {
+            //弹量逐步消耗, 耗尽后补满
+            GBIResources data;
+            data.id = index;
+            data.bullet_quantity = 8 - (static_cast<int>(t / 5) + index) % 9;
+            pack(data, precord);
+            break;
+        }
+        case GUIDANCE_RADAR: {
+            GuidanceRadar data;
+            data.id = index;
+            data.res_occu_rate = 50.0 + 40.0 * std::sin(t * 0.2 + phase);
+            pack(data, precord);
+            break;
+        }
+        case FIREPOWER_UNIT: {
+            FirepowerUnit data;
+            data.lon = static_cast<int>(t / 30) % 4;
+            data.command_mode = static_cast<int>(t / 20) % 3;
+            data.oper_task = static_cast<int>(t / 10) % 10;
+            data.inter_ception_mode = static_cast<int>(t / 15) % 2;
+            data.frequency_point_id = static_cast<int>(t / 5) % 32;
+            data.sector_central_angle = std::fmod(t * 3.0, 360.0);
+            pack(data, precord);
+            break;
+        }
+        case FIREPOWER_UNIT_AISLE: {
+            //主键为 (火力单元, 目标), 每个火力单元 50 个通道, 状态循环
+            FirepowerUnitAisle data;
+            data.unit_id = index / 50;
+            data.target_id = index % 50;
+            data.status = (static_cast<int>(t * 0.5) + index) % 5;
+            pack(data, precord);
+            break;
+        }
+        default:
+            break;
+    }
+}
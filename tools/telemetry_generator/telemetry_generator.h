@@ -0,0 +1,74 @@
+#ifndef __TELEMETRY_GENERATOR_H__
+#define __TELEMETRY_GENERATOR_H__
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QObject>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+
+#include "src/models/element_record.h"
+
+/*
+ *  合成遥测负载
+ *  每种装备类型有若干实体, 每个实体按固定频率轮流更新, 数值随时间连续变化
+ *  (光电装备绕圈移动、干扰方向扫描、通道状态循环等), 编码为遥测帧后发往
+ *  本机 UDP 端口或写入帧文件, 与主程序的 --udp-port / --frame-file 对应
+ */
+class TelemetryGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryGenerator(QObject *parent = nullptr);
+
+    //实体数量, 没有主键的类型只有一个实体
+    void set_count(ElementType type, int count);
+    int count(ElementType type) const { return counts_[type]; }
+    //每个实体每秒的更新次数
+    void set_rate(double hz) { rate_ = qMax(0.0, hz); }
+
+    void set_udp_target(const QHostAddress &address, quint16 port);
+    bool set_file_target(const QString &path, QString *perror = nullptr);
+
+    //持续 duration_s 秒, 0 表示一直发送
+    void start(int duration_s);
+
+signals:
+    void sig_finished();
+
+private slots:
+    void on_timer();
+
+private:
+    void fill_record(ElementType type, int index, double t, ElementRecord *precord) const;
+    void send(ElementType type, const ElementRecord *records, int count);
+    void report(qint64 elapsed_ms);
+
+private:
+    int counts_[ELEMENT_TYPE_COUNT];
+    int next_[ELEMENT_TYPE_COUNT];   //下一个待更新的实体
+    double due_[ELEMENT_TYPE_COUNT]; //累计应更新但未发出的条数
+    double rate_ = 10.0;
+
+    QUdpSocket socket_;
+    QHostAddress address_ = QHostAddress::LocalHost;
+    quint16 port_ = 6000;
+    QFile file_;
+
+    QTimer timer_;
+    QElapsedTimer clock_;
+    qint64 last_ms_ = 0;
+    qint64 duration_ms_ = 0;
+    qint64 report_ms_ = 0;
+    QVector<ElementRecord> records_;
+
+    quint32 sequence_ = 0;
+    quint64 sent_records_ = 0;
+    quint64 sent_frames_ = 0;
+    quint64 failed_frames_ = 0;
+    quint64 reported_records_ = 0;
+};
+
+#endif //__TELEMETRY_GENERATOR_H__
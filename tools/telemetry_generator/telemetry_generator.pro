@@ -0,0 +1,35 @@
+#-------------------------------------------------
+#
+# 遥测负载发生器, 合成各类装备数据并按遥测帧格式发送
+#
+#-------------------------------------------------
+
+QT       += core network
+QT       -= gui
+
+TARGET = telemetry_generator
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# 与主程序共用帧编码和描述表
+ROOT = $$PWD/../..
+INCLUDEPATH += $${ROOT}
+
+SOURCES += \
+    $${ROOT}/src/io/telemetry_codec.cpp \
+    $${ROOT}/src/models/element_descriptor.cpp \
+    $${ROOT}/src/models/element_record.cpp \
+    main.cpp \
+    telemetry_generator.cpp
+
+HEADERS += \
+    $${ROOT}/src/io/telemetry_codec.h \
+    $${ROOT}/src/models/element_descriptor.h \
+    $${ROOT}/src/models/element_record.h \
+    $${ROOT}/src/models/elements.h \
+    $${ROOT}/src/utils/command_line.h \
+    telemetry_generator.h
@@ -0,0 +1,174 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QVector>
+#include <QtEndian>
+#include <algorithm>
+
+#include "src/io/tile_archive_format.h"
+
+struct TileFile {
+    quint64 tile_id;
+    QString path;
+};
+
+//目录或文件名是否为非负整数, 同时返回数值
+static bool to_index(const QString &name, int *pvalue) {
+    bool ok = false;
+    *pvalue = name.toInt(&ok);
+    return ok && *pvalue >= 0;
+}
+
+//按 {z}/{x}/{y}.png 收集瓦片, 其他文件忽略
+static QVector<TileFile> collect_tiles(const QString &root, int *pmin_zoom, int *pmax_zoom) {
+    QVector<TileFile> tiles;
+    *pmin_zoom = 255;
+    *pmax_zoom = -1;
+
+    QDir root_dir(root);
+    for (const QString &zname : root_dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        int z;
+        if (!to_index(zname, &z) || z > 30) continue;
+
+        QDir zdir(root_dir.filePath(zname));
+        for (const QString &xname : zdir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            int x;
+            if (!to_index(xname, &x)) continue;
+
+            QDir xdir(zdir.filePath(xname));
+            for (const QString &yname : xdir.entryList(QStringList() << "*.png", QDir::Files)) {
+                int y;
+                if (!to_index(yname.left(yname.size() - 4), &y)) continue;
+
+                TileFile tile;
+                tile.tile_id = tile_archive_id(z, x, y);
+                tile.path = xdir.filePath(yname);
+                tiles.append(tile);
+                *pmin_zoom = qMin(*pmin_zoom, z);
+                *pmax_zoom = qMax(*pmax_zoom, z);
+            }
+        }
+    }
+
+    std::sort(tiles.begin(), tiles.end(),
+              [](const TileFile &a, const TileFile &b) { return a.tile_id < b.tile_id; });
+    return tiles;
+}
+
+//从 PNG 文件头的 IHDR 块读取宽高, 不解码图像
+static bool png_size(const QString &path, int *pwidth, int *pheight) {
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    QFile png(path);
+    if (!png.open(QFile::ReadOnly)) return false;
+
+    QByteArray head = png.read(24);
+    if (head.size() < 24 || !head.startsWith(QByteArray(signature, 8)) || head.mid(12, 4) != "IHDR") return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(head.constData());
+    *pwidth = static_cast<int>(qFromBigEndian<quint32>(p + 16));
+    *pheight = static_cast<int>(qFromBigEndian<quint32>(p + 20));
+    return true;
+}
+
+/*
+ *  用法: tile_packer <瓦片目录> <归档文件> [瓦片边长(默认 256)]
+ *  例如: tile_packer resouces/Tiles Tiles.edta
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (args.size() < 3) {
+        err << "用法: tile_packer <瓦片目录> <归档文件> [瓦片边长]" << endl;
+        return 1;
+    }
+    //瓦片边长写入归档头, 画布按它换算比例尺, 必须与瓦片实际尺寸一致
+    bool ok = true;
+    int tile_size = (args.size() > 3) ? args.at(3).toInt(&ok) : 256;
+    if (!ok || tile_size <= 0 || tile_size > 0xFFFF) {
+        err << "瓦片边长无效: " << args.at(3) << endl;
+        return 1;
+    }
+
+    int min_zoom, max_zoom;
+    QVector<TileFile> tiles = collect_tiles(args.at(1), &min_zoom, &max_zoom);
+    if (tiles.isEmpty()) {
+        err << args.at(1) << " 中没有 {z}/{x}/{y}.png 瓦片" << endl;
+        return 1;
+    }
+
+    int width = 0, height = 0;
+    if (!png_size(tiles.first().path, &width, &height)) {
+        err << tiles.first().path << " 不是有效的 PNG 文件" << endl;
+        return 1;
+    }
+    if (width != tile_size || height != tile_size) {
+        err << QString("瓦片边长 %1 与 %2 的实际尺寸 %3x%4 不符")
+                   .arg(tile_size)
+                   .arg(tiles.first().path)
+                   .arg(width)
+                   .arg(height)
+            << endl;
+        return 1;
+    }
+
+    QFile file(args.at(2));
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        err << "无法创建 " << args.at(2) << ": " << file.errorString() << endl;
+        return 1;
+    }
+
+    // 1.文件头和索引先占位, 数据写完后回填
+    TileArchiveHeader header = {};
+    header.magic = TILE_ARCHIVE_MAGIC;
+    header.version = TILE_ARCHIVE_VERSION;
+    header.tile_size = tile_size;
+    header.min_zoom = min_zoom;
+    header.max_zoom = max_zoom;
+    header.tile_count = tiles.size();
+    header.index_offset = sizeof(header);
+    header.data_offset = header.index_offset + tiles.size() * sizeof(TileArchiveEntry);
+
+    QVector<TileArchiveEntry> entries(tiles.size());
+    file.resize(header.data_offset);
+    file.seek(header.data_offset);
+
+    // 2.按索引顺序写入各瓦片的 PNG 数据
+    qint64 offset = header.data_offset;
+    for (int i = 0; i < tiles.size(); i++) {
+        QFile png(tiles.at(i).path);
+        QByteArray data;
+        if (png.open(QFile::ReadOnly)) data = png.readAll();
+        if (data.isEmpty() || file.write(data) != data.size()) {
+            err << "无法读取或写入 " << tiles.at(i).path << endl;
+            return 1;
+        }
+
+        TileArchiveEntry &entry = entries[i];
+        entry.tile_id = tiles.at(i).tile_id;
+        entry.offset = offset;
+        entry.size = data.size();
+        entry.reserved = 0;
+        offset += data.size();
+    }
+
+    // 3.回填文件头和索引
+    if (!file.seek(0) || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header) ||
+        file.write(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(TileArchiveEntry)) !=
+            static_cast<qint64>(entries.size() * sizeof(TileArchiveEntry))) {
+        err << "写入 " << args.at(2) << " 失败: " << file.errorString() << endl;
+        return 1;
+    }
+    file.close();
+
+    out << QString("已打包 %1 个瓦片, 层级 %2 - %3, 共 %4 MB")
+               .arg(tiles.size())
+               .arg(min_zoom)
+               .arg(max_zoom)
+               .arg(offset / (1024.0 * 1024.0), 0, 'f', 1)
+        << endl;
+    return 0;
+}
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# 瓦片打包工具, 把 {z}/{x}/{y}.png 目录树转换为单个瓦片归档
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = tile_packer
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# 与主程序共用归档格式
+ROOT = $$PWD/../..
+INCLUDEPATH += $${ROOT}
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    $${ROOT}/src/io/tile_archive_format.h